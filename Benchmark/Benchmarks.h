@@ -0,0 +1,82 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include <flecs.h>
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+namespace Benchmarks
+{
+
+/**
+ * @brief Collects the results of every suite, printed as they come and written as JSON at the end.
+ */
+class Report
+{
+public:
+    void Add(const std::string& suite, const std::string& name, int entities, double value, const std::string& unit);
+
+    /** @brief Records a check that didn't hold, the benchmark then exits with a failure once the report is written. */
+    void Fail(const std::string& suite, const std::string& message);
+
+    [[nodiscard]] bool HasFailures() const
+    {
+        return !_failures.empty();
+    }
+
+    bool WriteJson(const std::filesystem::path& path) const;
+
+private:
+    nlohmann::json _results = nlohmann::json::array();
+    nlohmann::json _failures = nlohmann::json::array();
+};
+
+/**
+ * @brief Runs func `iterations` times and reports the average time per iteration.
+ */
+template <typename Func>
+double Measure(Report& report, const std::string& suite, const std::string& name, const int entities,
+               const int iterations, Func&& func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        func(i);
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    const double nanoseconds = elapsed.count() / iterations;
+    report.Add(suite, name, entities, nanoseconds, "ns/op");
+    return nanoseconds;
+}
+
+/**
+ * @brief System registered by a module, looked up in the scope of the module entity where flecs names it.
+ */
+template <typename Module>
+flecs::system FindSystem(const flecs::world& world, const char* name)
+{
+    const flecs::entity system = world.entity<Module>().lookup(name);
+    if (!system)
+    {
+        // Timing a null system would report a meaningless number
+        std::fprintf(stderr, "System %s not found\n", name);
+        std::exit(EXIT_FAILURE);
+    }
+    return world.system(system);
+}
+
+void RunEvents(Report& report);
+void RunInput(Report& report);
+void RunLifetime(Report& report);
+void RunParticles(Report& report);
+void RunPhysics(Report& report);
+void RunSpatialQuery(Report& report);
+
+} // namespace Benchmarks
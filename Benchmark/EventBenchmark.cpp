@@ -0,0 +1,315 @@
+// Copyright (c) Eric Jeker 2025.
+
+#include "Benchmarks.h"
+
+#include "SFE/Managers/EventManager.h"
+#include "SFE/Modules/Event/EventBus.h"
+#include "SFE/Modules/Event/EventModule.h"
+#include "SFE/Modules/Input/Components/Command.h"
+#include "SFE/Modules/Input/Components/Target.h"
+#include "SFE/Modules/Input/InputModule.h"
+#include "SFE/Modules/Lifetime/Components/LifetimeOneFrame.h"
+#include "SFE/Modules/Lifetime/LifetimeModule.h"
+#include "SFE/Modules/Lifetime/Singletons/EntityPool.h"
+#include "SFE/Modules/UI/Components/KeyPressed.h"
+
+#include <algorithm>
+#include <barrier>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+
+constexpr auto SUITE = "Events";
+constexpr float DELTA_TIME = 1.f / 60.f;
+constexpr int EVENTS = 10'000;
+constexpr int FRAMES = 60;
+constexpr int MANAGER_EVENTS = 100'000;
+constexpr int PRODUCER_EVENTS = 25'000;
+
+struct DamageTick
+{
+    std::uint32_t target;
+    float amount;
+};
+
+// Command tag of a game, inherited from its binding prefab so it can't be toggled
+struct Jump
+{
+};
+
+enum class Transport
+{
+    Entities,
+    PooledEntities,
+    Bus,
+    DeferredBus
+};
+
+const char* ToString(const Transport transport)
+{
+    switch (transport)
+    {
+        case Transport::Entities: return "One-frame entities";
+        case Transport::PooledEntities: return "Pooled one-frame entities";
+        case Transport::Bus: return "Event bus";
+        case Transport::DeferredBus: return "Event bus, emitted from a system";
+    }
+    return "";
+}
+
+KeyPressed MakeEvent(const int i)
+{
+    return {.code = static_cast<sf::Keyboard::Key>(i % 26)};
+}
+
+/**
+ * Each frame sends EVENTS key presses and a consumer reads them back, the whole frame is timed.
+ */
+void Run(Benchmarks::Report& report, const Transport transport)
+{
+    flecs::world world;
+    world.import<Core::Modules::LifetimeModule>();
+    world.import<Core::Modules::EventModule>();
+
+    // As the UIModule does, the released pooled entities are hidden from the consumer by toggling KeyPressed off
+    world.component<KeyPressed>().add(flecs::CanToggle);
+    const flecs::entity prefab = world.prefab().add<LifetimeOneFrame>().add<KeyPressed>();
+
+    long long consumed = 0;
+    if (transport == Transport::Entities || transport == Transport::PooledEntities)
+    {
+        world.system<const KeyPressed>("ConsumeKeyPressed").kind(flecs::OnUpdate).each([&](const KeyPressed& event) {
+            consumed += static_cast<int>(event.code) >= 0 ? 1 : 0;
+        });
+    }
+    else
+    {
+        Events::Subscribe<KeyPressed>(world, [&](flecs::entity, const KeyPressed& event) {
+            consumed += static_cast<int>(event.code) >= 0 ? 1 : 0;
+        });
+    }
+
+    if (transport == Transport::DeferredBus)
+    {
+        world.system("EmitKeyPressed").kind(flecs::PostLoad).run([](const flecs::iter& it) {
+            for (int i = 0; i < EVENTS; ++i)
+            {
+                Events::Emit(it.world(), MakeEvent(i));
+            }
+        });
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < FRAMES; ++frame)
+    {
+        switch (transport)
+        {
+            case Transport::Entities:
+                for (int i = 0; i < EVENTS; ++i)
+                {
+                    world.entity().is_a(prefab).set<KeyPressed>(MakeEvent(i));
+                }
+                break;
+
+            case Transport::PooledEntities:
+            {
+                auto& pool = world.get_mut<EntityPool>();
+                for (int i = 0; i < EVENTS; ++i)
+                {
+                    pool.Acquire(world, prefab).set<KeyPressed>(MakeEvent(i));
+                }
+                break;
+            }
+
+            case Transport::Bus:
+                for (int i = 0; i < EVENTS; ++i)
+                {
+                    Events::Emit(world, MakeEvent(i));
+                }
+                break;
+
+            case Transport::DeferredBus:
+                break;
+        }
+
+        world.progress(DELTA_TIME);
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    report.Add(SUITE, ToString(transport), EVENTS, elapsed.count() / (static_cast<double>(EVENTS) * FRAMES), "ns/event");
+    if (consumed != static_cast<long long>(EVENTS) * FRAMES)
+    {
+        std::printf("  %s consumed %lld events instead of %d\n", ToString(transport), consumed, EVENTS * FRAMES);
+    }
+}
+
+/**
+ * A command acquired as the InputSystem does is released at the end of the frame, the query of its consumer must not
+ * match it anymore even though its prefab's tag is still inherited.
+ */
+void CheckReleasedCommand(Benchmarks::Report& report)
+{
+    flecs::world world;
+    world.import<Core::Modules::LifetimeModule>();
+    world.import<Core::Modules::InputModule>();
+
+    const flecs::entity prefab = world.prefab().add<Jump>();
+    const auto jumps = world.query_builder<const Jump>().with<Command>().build();
+
+    const flecs::entity player = world.entity();
+    world.get_mut<EntityPool>().Acquire(world, prefab).add<LifetimeOneFrame>().add<Command>().set<Target>({player});
+    const int live = jumps.count();
+    world.progress(DELTA_TIME);
+
+    if (live != 1 || jumps.count() != 0)
+    {
+        report.Fail(SUITE, "The released command still matches the query on its prefab's tag");
+    }
+}
+
+/**
+ * Each frame queues MANAGER_EVENTS damage ticks on the EventManager and flushes them to a listener that sums the
+ * damage, either called once per event or once with the whole batch.
+ */
+void RunManager(Benchmarks::Report& report, const bool batched)
+{
+    EventManager eventManager;
+
+    double damage = 0.;
+    if (batched)
+    {
+        eventManager.SubscribeBatch<DamageTick>([&](const std::span<const DamageTick> events) {
+            for (const DamageTick& event : events)
+            {
+                damage += event.amount;
+            }
+        });
+    }
+    else
+    {
+        eventManager.Subscribe<DamageTick>([&](const DamageTick& event, void*) { damage += event.amount; });
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < FRAMES; ++frame)
+    {
+        for (int i = 0; i < MANAGER_EVENTS; ++i)
+        {
+            eventManager.EmitDeferred(DamageTick{static_cast<std::uint32_t>(i), 1.f}, nullptr);
+        }
+        eventManager.ProcessDeferredEvents();
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    const char* name = batched ? "EventManager, batch listener" : "EventManager, per-event listener";
+    report.Add(SUITE, name, MANAGER_EVENTS, elapsed.count() / (static_cast<double>(MANAGER_EVENTS) * FRAMES),
+               "ns/event");
+    if (damage != static_cast<double>(MANAGER_EVENTS) * FRAMES)
+    {
+        std::printf("  %s consumed %.0f events instead of %d\n", name, damage, MANAGER_EVENTS * FRAMES);
+    }
+}
+
+/**
+ * Each frame every producer thread queues PRODUCER_EVENTS damage ticks, then the main thread flushes them once they
+ * are all done. The per-thread buffers of EmitDeferred are compared with a single vector behind a mutex.
+ */
+void RunProducers(Benchmarks::Report& report, const int producers, const bool locked)
+{
+    EventManager eventManager;
+    std::mutex mutex;
+    std::vector<DamageTick> lockedEvents;
+
+    double damage = 0.;
+    eventManager.SubscribeBatch<DamageTick>([&](const std::span<const DamageTick> events) {
+        for (const DamageTick& event : events)
+        {
+            damage += event.amount;
+        }
+    });
+
+    // The producers wait for the frame to start, and the main thread waits for them to be done before flushing
+    std::barrier sync(producers + 1);
+    std::vector<std::jthread> threads;
+    for (int producer = 0; producer < producers; ++producer)
+    {
+        threads.emplace_back([&, producer] {
+            for (int frame = 0; frame < FRAMES; ++frame)
+            {
+                sync.arrive_and_wait();
+                for (int i = 0; i < PRODUCER_EVENTS; ++i)
+                {
+                    const DamageTick event{static_cast<std::uint32_t>(producer * PRODUCER_EVENTS + i), 1.f};
+                    if (locked)
+                    {
+                        std::scoped_lock lock(mutex);
+                        lockedEvents.push_back(event);
+                    }
+                    else
+                    {
+                        eventManager.EmitDeferred(event, nullptr);
+                    }
+                }
+                sync.arrive_and_wait();
+            }
+        });
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < FRAMES; ++frame)
+    {
+        sync.arrive_and_wait();
+        sync.arrive_and_wait();
+        for (const DamageTick& event : lockedEvents)
+        {
+            eventManager.EmitDeferred(event, nullptr);
+        }
+        lockedEvents.clear();
+        eventManager.ProcessDeferredEvents();
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    threads.clear();
+
+    const int events = producers * PRODUCER_EVENTS;
+    const std::string name = std::string(locked ? "Mutex-guarded vector, " : "Per-thread buffers, ") +
+                             std::to_string(producers) + (producers == 1 ? " producer" : " producers");
+    report.Add(SUITE, name, events, elapsed.count() / (static_cast<double>(events) * FRAMES), "ns/event");
+    if (damage != static_cast<double>(events) * FRAMES)
+    {
+        std::printf("  %s consumed %.0f events instead of %d\n", name.c_str(), damage, events * FRAMES);
+    }
+}
+
+} // namespace
+
+namespace Benchmarks
+{
+
+void RunEvents(Report& report)
+{
+    std::printf("Events, %d per frame\n", EVENTS);
+    for (const Transport transport :
+         {Transport::Entities, Transport::PooledEntities, Transport::Bus, Transport::DeferredBus})
+    {
+        Run(report, transport);
+    }
+    CheckReleasedCommand(report);
+
+    std::printf("EventManager, %d deferred events per frame\n", MANAGER_EVENTS);
+    RunManager(report, false);
+    RunManager(report, true);
+    std::printf("\n");
+
+    std::printf("EventManager, %d deferred events per producer thread per frame\n", PRODUCER_EVENTS);
+    const int maxProducers = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    for (int producers = 1; producers <= std::min(8, maxProducers); producers *= 2)
+    {
+        RunProducers(report, producers, true);
+        RunProducers(report, producers, false);
+    }
+    std::printf("\n");
+}
+
+} // namespace Benchmarks
@@ -0,0 +1,197 @@
+// Copyright (c) Eric Jeker 2025.
+
+#include "Benchmarks.h"
+
+#include "SFE/Modules/Input/InputRecording.h"
+#include "SFE/Modules/Input/Singletons/InputSnapshot.h"
+
+#include <array>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+constexpr auto SUITE = "Input";
+constexpr int FRAMES = 10'000;
+
+struct Frame
+{
+    std::vector<sf::Event> events;
+    InputSnapshot::Bits live;
+    InputSnapshot::Axes axes{};
+    float deltaTime = 0.f;
+};
+
+/**
+ * The fields of the event the recording keeps, to compare it with its replayed copy.
+ */
+std::array<int, 5> Fields(const sf::Event& event)
+{
+    if (const auto* key = event.getIf<sf::Event::KeyPressed>())
+    {
+        return {1, static_cast<int>(key->code), static_cast<int>(key->scancode), key->shift, key->control};
+    }
+    if (const auto* key = event.getIf<sf::Event::KeyReleased>())
+    {
+        return {2, static_cast<int>(key->code), static_cast<int>(key->scancode), key->alt, key->system};
+    }
+    if (const auto* mouse = event.getIf<sf::Event::MouseButtonPressed>())
+    {
+        return {3, static_cast<int>(mouse->button), mouse->position.x, mouse->position.y, 0};
+    }
+    if (const auto* mouse = event.getIf<sf::Event::MouseButtonReleased>())
+    {
+        return {4, static_cast<int>(mouse->button), mouse->position.x, mouse->position.y, 0};
+    }
+    if (event.is<sf::Event::FocusLost>())
+    {
+        return {5, 0, 0, 0, 0};
+    }
+    return {0, 0, 0, 0, 0};
+}
+
+/**
+ * A player mashing keys and clicking around with a joystick, frames of uneven length. The snapshot is fed by the
+ * events and by Override for the axes, so the devices of the machine don't get into the recording.
+ */
+std::vector<Frame> Generate()
+{
+    std::mt19937 rng(42);
+    std::uniform_int_distribution percent(0, 99);
+    std::uniform_int_distribution key(0, 25);
+    std::uniform_int_distribution position(0, 1920);
+    std::uniform_real_distribution axis(-100.f, 100.f);
+    std::uniform_real_distribution jitter(-0.002f, 0.002f);
+
+    std::vector<Frame> frames(FRAMES);
+    InputSnapshot snapshot;
+    InputSnapshot::Axes axes{};
+    for (Frame& frame : frames)
+    {
+        if (percent(rng) < 30)
+        {
+            sf::Event::KeyPressed pressed{};
+            pressed.code = static_cast<sf::Keyboard::Key>(key(rng));
+            pressed.shift = percent(rng) < 20;
+            frame.events.emplace_back(pressed);
+        }
+        if (percent(rng) < 30)
+        {
+            sf::Event::KeyReleased released{};
+            released.code = static_cast<sf::Keyboard::Key>(key(rng));
+            frame.events.emplace_back(released);
+        }
+        if (percent(rng) < 5)
+        {
+            frame.events.emplace_back(sf::Event::MouseButtonPressed{sf::Mouse::Button::Left,
+                                                                    {position(rng), position(rng)}});
+            frame.events.emplace_back(sf::Event::MouseButtonReleased{sf::Mouse::Button::Left,
+                                                                     {position(rng), position(rng)}});
+        }
+        if (percent(rng) == 0)
+        {
+            frame.events.emplace_back(sf::Event::FocusLost{});
+        }
+        if (percent(rng) < 10)
+        {
+            axes[0] = axis(rng);
+        }
+
+        for (const sf::Event& event : frame.events)
+        {
+            snapshot.Apply(event);
+        }
+        snapshot.Override(snapshot.GetLive(), axes);
+
+        frame.live = snapshot.GetLive();
+        frame.axes = axes;
+        frame.deltaTime = 1.f / 60.f + jitter(rng);
+    }
+    return frames;
+}
+
+/**
+ * Records the frames, replays them and checks every frame comes back identical: the events, the controls, the axes and
+ * the delta time.
+ */
+void RunRoundTrip(Benchmarks::Report& report)
+{
+    const std::vector<Frame> frames = Generate();
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "SFEInputBenchmark.sfei";
+
+    {
+        InputRecorder recorder(path);
+        if (!recorder.IsOpen())
+        {
+            report.Fail(SUITE, "Cannot write the recording " + path.string());
+            return;
+        }
+
+        InputSnapshot snapshot;
+        Benchmarks::Measure(report, SUITE, "Record frame", 0, FRAMES, [&](const int i) {
+            for (const sf::Event& event : frames[i].events)
+            {
+                recorder.RecordEvent(event);
+            }
+            snapshot.Override(frames[i].live, frames[i].axes);
+            recorder.EndFrame(snapshot, frames[i].deltaTime);
+        });
+    }
+    report.Add(SUITE, "Recording size", 0, static_cast<double>(std::filesystem::file_size(path)) / FRAMES,
+               "bytes/frame");
+
+    InputReplay replay(path);
+    if (!replay.IsOpen())
+    {
+        report.Fail(SUITE, "Cannot read back the recording " + path.string());
+        return;
+    }
+
+    int mismatches = 0;
+    int replayed = 0;
+    InputSnapshot snapshot;
+    Benchmarks::Measure(report, SUITE, "Replay frame", 0, FRAMES, [&](const int i) {
+        if (!replay.NextFrame())
+        {
+            return;
+        }
+        replay.ApplyTo(snapshot);
+        ++replayed;
+
+        const Frame& frame = frames[i];
+        bool same = replay.GetDeltaTime() == frame.deltaTime && snapshot.GetLive() == frame.live &&
+                    snapshot.GetAxes() == frame.axes && replay.GetEvents().size() == frame.events.size();
+        for (std::size_t e = 0; same && e < frame.events.size(); ++e)
+        {
+            same = Fields(replay.GetEvents()[e]) == Fields(frame.events[e]);
+        }
+        mismatches += same ? 0 : 1;
+    });
+
+    std::filesystem::remove(path);
+
+    if (replayed != FRAMES || replay.NextFrame())
+    {
+        report.Fail(SUITE, "The replay has " + std::to_string(replayed) + " frames instead of " +
+                               std::to_string(FRAMES));
+    }
+    if (mismatches > 0)
+    {
+        report.Fail(SUITE, std::to_string(mismatches) + " replayed frames differ from their recording");
+    }
+}
+
+} // namespace
+
+namespace Benchmarks
+{
+
+void RunInput(Report& report)
+{
+    std::printf("Input, %d frames recorded and replayed\n", FRAMES);
+    RunRoundTrip(report);
+    std::printf("\n");
+}
+
+} // namespace Benchmarks
@@ -0,0 +1,55 @@
+// Copyright (c) Eric Jeker 2025.
+
+#include "Benchmarks.h"
+
+#include "SFE/Modules/Lifetime/Components/Lifetime.h"
+#include "SFE/Modules/Lifetime/LifetimeModule.h"
+
+#include <random>
+
+namespace
+{
+
+constexpr auto SUITE = "Lifetime";
+constexpr float DELTA_TIME = 1.f / 60.f;
+constexpr int FRAMES = 120;
+
+/**
+ * count timed entities living from 10 to 20 seconds: only a handful expire during the measured frames, the frame
+ * cost should not follow the number of entities.
+ */
+void Run(Benchmarks::Report& report, const int count)
+{
+    flecs::world world;
+    world.import<Core::Modules::LifetimeModule>();
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution seconds(10.f, 20.f);
+    for (int i = 0; i < count; ++i)
+    {
+        world.entity().set<Lifetime>({.seconds = i % 100 == 0 ? seconds(rng) - 9.f : seconds(rng)});
+    }
+
+    const flecs::system system = Benchmarks::FindSystem<Core::Modules::LifetimeModule>(world, "LifetimeExpirySystem");
+    const int before = world.count<Lifetime>();
+
+    Benchmarks::Measure(report, SUITE, "Expiry frame", count, FRAMES, [&](int) { system.run(DELTA_TIME); });
+    report.Add(SUITE, "Expired", count, before - world.count<Lifetime>(), "entities");
+}
+
+} // namespace
+
+namespace Benchmarks
+{
+
+void RunLifetime(Report& report)
+{
+    std::printf("Lifetime\n");
+    for (const int count : {1'000, 10'000, 100'000})
+    {
+        Run(report, count);
+    }
+    std::printf("\n");
+}
+
+} // namespace Benchmarks
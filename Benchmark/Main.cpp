@@ -0,0 +1,28 @@
+// Copyright (c) Eric Jeker 2025.
+
+#include "Benchmarks.h"
+
+/**
+ * Usage: SFEBenchmark [output.json]
+ */
+int main(const int argc, char* argv[])
+{
+    const std::filesystem::path output = argc > 1 ? argv[1] : "benchmark.json";
+
+    Benchmarks::Report report;
+    Benchmarks::RunEvents(report);
+    Benchmarks::RunInput(report);
+    Benchmarks::RunLifetime(report);
+    Benchmarks::RunParticles(report);
+    Benchmarks::RunPhysics(report);
+    Benchmarks::RunSpatialQuery(report);
+
+    if (!report.WriteJson(output))
+    {
+        std::fprintf(stderr, "Could not write %s\n", output.string().c_str());
+        return 1;
+    }
+
+    std::printf("Results written to %s\n", output.string().c_str());
+    return report.HasFailures() ? 1 : 0;
+}
@@ -0,0 +1,224 @@
+// Copyright (c) Eric Jeker 2025.
+
+#include "Benchmarks.h"
+
+#include "SFE/Modules/Lifetime/Components/Lifetime.h"
+#include "SFE/Modules/Particles/Components/ParticleEmitter.h"
+#include "SFE/Modules/Particles/ParticleThrottle.h"
+#include "SFE/Modules/Particles/ParticlesModule.h"
+#include "SFE/Modules/Particles/Prefabs/Particle.h"
+#include "SFE/Modules/Particles/Singletons/ParticleForces.h"
+#include "SFE/Modules/Physics/Components/Velocity.h"
+#include "SFE/Modules/Render/Components/Transform.h"
+#include "SFE/Modules/Render/Components/ZOrder.h"
+#include "SFE/Utils/Random.h"
+
+#include <algorithm>
+#include <random>
+#include <thread>
+
+namespace
+{
+
+constexpr auto SUITE = "Particles";
+constexpr float DELTA_TIME = 1.f / 60.f;
+constexpr int PARTICLES = 100'000;
+constexpr int FRAMES = 10;
+constexpr int SIMULATED_FRAMES = 60;
+
+enum class Spawner
+{
+    PerParticle,
+    Bulk,
+    Buffer
+};
+
+const char* ToString(const Spawner spawner)
+{
+    switch (spawner)
+    {
+        case Spawner::PerParticle: return "Per particle generator";
+        case Spawner::Bulk: return "Bulk entities";
+        case Spawner::Buffer: return "Buffer";
+    }
+    return "";
+}
+
+// The generator the emitters used before the batched spawns, kept to compare against
+flecs::entity GenerateOne(const flecs::world world, const ParticleEmitter& emitter, const Transform& transform)
+{
+    const auto velocity = Random::UniformFloat(emitter.minVelocity, emitter.maxVelocity);
+    return world.entity()
+        .is_a<Prefabs::Particle>()
+        .set<Velocity>({{Random::UniformFloat(-velocity, velocity), Random::UniformFloat(-velocity, velocity)}})
+        .set<ZOrder>({1000.f})
+        .set<Transform>({.position = transform.position})
+        .set<Lifetime>({Random::UniformFloat(emitter.minLifetime, emitter.maxLifetime)});
+}
+
+/**
+ * Every frame spawns the full 100k particles in a fresh world, the whole spawn is timed.
+ */
+void Run(Benchmarks::Report& report, const Spawner spawner)
+{
+    std::chrono::nanoseconds total{0};
+
+    for (int frame = 0; frame < FRAMES; ++frame)
+    {
+        flecs::world world;
+        world.import<Core::Modules::ParticlesModule>();
+
+        ParticleEmitter emitter;
+        emitter.ratePerSecond = static_cast<float>(PARTICLES) / DELTA_TIME;
+        emitter.maxParticles = PARTICLES;
+        emitter.storage = spawner == Spawner::Buffer ? ParticleStorage::Buffer : ParticleStorage::Entities;
+        if (spawner == Spawner::PerParticle)
+        {
+            emitter.generator = GenerateOne;
+        }
+
+        const flecs::entity entity = world.entity().set<Transform>({.position = {400.f, 300.f}});
+        entity.set<ParticleEmitter>(std::move(emitter));
+
+        const flecs::system system =
+            Benchmarks::FindSystem<Core::Modules::ParticlesModule>(world, "ParticleEmitterSystem");
+
+        const auto start = std::chrono::steady_clock::now();
+        system.run(DELTA_TIME);
+        total += std::chrono::steady_clock::now() - start;
+
+        const int live = entity.get<ParticleEmitter>().liveParticles;
+        if (live != PARTICLES)
+        {
+            std::printf("  %s spawned %d particles instead of %d\n", ToString(spawner), live, PARTICLES);
+        }
+    }
+
+    const double perParticle = static_cast<double>(total.count()) / (static_cast<double>(PARTICLES) * FRAMES);
+    report.Add(SUITE, ToString(spawner), PARTICLES, perParticle, "ns/particle");
+}
+
+/**
+ * A single buffered emitter holding count particles, moved under every kind of force for a second.
+ */
+void RunSimulation(Benchmarks::Report& report, const int count)
+{
+    flecs::world world;
+    world.import<Core::Modules::ParticlesModule>();
+
+    auto& forces = world.get_mut<ParticleForces>();
+    forces.gravity = {0.f, 98.f};
+    forces.drag = 0.1f;
+    forces.attractors = {{.position = {200.f, 300.f}, .strength = 5000.f, .radius = 300.f},
+                         {.position = {600.f, 300.f}, .strength = 5000.f, .radius = 300.f}};
+    forces.vortices = {{.position = {400.f, 300.f}, .strength = 2000.f, .radius = 400.f}};
+
+    // The emitter doesn't spawn, the buffer is filled up front with particles outliving the benchmark
+    ParticleEmitter emitter;
+    emitter.enabled = false;
+    emitter.storage = ParticleStorage::Buffer;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution position(0.f, 800.f);
+    std::uniform_real_distribution speed(-50.f, 50.f);
+    emitter.particles.Grow(static_cast<std::size_t>(count));
+    for (int i = 0; i < count; ++i)
+    {
+        emitter.particles.positions[i] = {position(rng), position(rng)};
+        emitter.particles.velocities[i] = {speed(rng), speed(rng)};
+        emitter.particles.lifetimes[i] = 1000.f;
+    }
+    world.entity().set<Transform>({}).set<ParticleEmitter>(std::move(emitter));
+
+    const flecs::system system = Benchmarks::FindSystem<Core::Modules::ParticlesModule>(world, "ParticleBufferSystem");
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < SIMULATED_FRAMES; ++frame)
+    {
+        system.run(DELTA_TIME);
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    report.Add(SUITE, "Simulation", count, elapsed.count() / (static_cast<double>(count) * SIMULATED_FRAMES),
+               "ns/particle/frame");
+}
+
+/**
+ * Drives the throttle with synthetic timings, so the result only depends on the code: a calm second, half a second
+ * of explosions taking three times the budget, then calm again until the throttle is back to full rate.
+ */
+void RunThrottle(Benchmarks::Report& report)
+{
+    using namespace std::chrono_literals;
+
+    constexpr std::chrono::nanoseconds budget = 2ms;
+    constexpr std::chrono::nanoseconds calm = 1ms;
+    constexpr std::chrono::nanoseconds explosion = 6ms;
+
+    float throttle = 1.f;
+    float lowest = 1.f;
+    int budgetHits = 0;
+    int frame = 0;
+
+    const auto step = [&](const std::chrono::nanoseconds measured) {
+        // The particles take less time as the throttle thins the spawns out
+        const auto throttled = std::chrono::duration_cast<std::chrono::nanoseconds>(measured * throttle);
+        budgetHits += throttled > budget ? 1 : 0;
+        throttle = ParticleThrottle::Update(throttle, throttled, budget, DELTA_TIME, 0.5f);
+        lowest = std::min(lowest, throttle);
+        frame++;
+    };
+
+    for (int i = 0; i < 60; ++i)
+    {
+        step(calm);
+    }
+    for (int i = 0; i < 30; ++i)
+    {
+        step(explosion);
+    }
+    const int explosionEnd = frame;
+    while (throttle < 1.f && frame < 10'000)
+    {
+        step(calm);
+    }
+
+    report.Add(SUITE, "Throttle lowest", 0, lowest, "throttle");
+    report.Add(SUITE, "Throttle lowest, priority 1", 0, ParticleThrottle::RateScale(lowest, 1), "throttle");
+    report.Add(SUITE, "Throttle lowest, priority 3", 0, ParticleThrottle::RateScale(lowest, 3), "throttle");
+    report.Add(SUITE, "Throttle budget hits", 0, budgetHits, "frames");
+    report.Add(SUITE, "Throttle recovery", 0, frame - explosionEnd, "frames");
+
+    if (budgetHits == 0 || lowest >= 1.f || throttle < 1.f)
+    {
+        report.Fail(SUITE, "The throttle didn't react to the synthetic explosion as expected");
+    }
+}
+
+} // namespace
+
+namespace Benchmarks
+{
+
+void RunParticles(Report& report)
+{
+    std::printf("Particles, %d in one frame\n", PARTICLES);
+    for (const Spawner spawner : {Spawner::PerParticle, Spawner::Bulk, Spawner::Buffer})
+    {
+        Run(report, spawner);
+    }
+    std::printf("\n");
+
+    std::printf("Particles, simulation with %u hardware threads\n", std::thread::hardware_concurrency());
+    for (const int count : {10'000, 100'000, 1'000'000})
+    {
+        RunSimulation(report, count);
+    }
+    std::printf("\n");
+
+    std::printf("Particles, throttle on synthetic timings\n");
+    RunThrottle(report);
+    std::printf("\n");
+}
+
+} // namespace Benchmarks
@@ -0,0 +1,191 @@
+// Copyright (c) Eric Jeker 2025.
+
+#include "Benchmarks.h"
+
+#include "SFE/Modules/Physics/Components/ColliderShape.h"
+#include "SFE/Modules/Physics/Components/ContinuousCollision.h"
+#include "SFE/Modules/Physics/Components/Velocity.h"
+#include "SFE/Modules/Physics/PhysicsModule.h"
+#include "SFE/Modules/Physics/Singletons/PhysicsStats.h"
+#include "SFE/Modules/Render/Components/Radius.h"
+#include "SFE/Modules/Render/Components/Transform.h"
+
+#include <array>
+#include <cmath>
+#include <random>
+#include <string>
+
+namespace
+{
+
+constexpr auto SUITE = "Physics";
+constexpr float DELTA_TIME = 1.f / 60.f;
+// Long enough for the resting bodies to fall asleep before measuring
+constexpr int WARMUP_STEPS = 60;
+constexpr int MEASURED_STEPS = 120;
+
+enum class Scenario
+{
+    Uniform,
+    Clustered,
+    Resting,
+    Fast
+};
+
+const char* ToString(const Scenario scenario)
+{
+    switch (scenario)
+    {
+        case Scenario::Uniform: return "Uniform";
+        case Scenario::Clustered: return "Clustered";
+        case Scenario::Resting: return "Resting";
+        case Scenario::Fast: return "Fast";
+    }
+    return "";
+}
+
+flecs::entity SpawnBody(const flecs::world& world, const sf::Vector2f& position, const sf::Vector2f& velocity,
+                        const float radius)
+{
+    return world.entity()
+        .set<Transform>({.position = position})
+        .set<Velocity>({.velocity = velocity})
+        .set<Radius>({.radius = radius})
+        .set<ColliderShape>({.shape = Shape::Circle});
+}
+
+void Populate(const flecs::world& world, const Scenario scenario, const int count)
+{
+    std::mt19937 rng(42);
+
+    // One body per 40x40 pixels on average
+    const float side = std::sqrt(static_cast<float>(count) * 1600.f);
+    std::uniform_real_distribution position(0.f, side);
+    std::uniform_real_distribution speed(-100.f, 100.f);
+    std::uniform_real_distribution radius(4.f, 8.f);
+    std::uniform_real_distribution angle(0.f, 6.2831853f);
+
+    switch (scenario)
+    {
+        case Scenario::Uniform:
+            for (int i = 0; i < count; ++i)
+            {
+                SpawnBody(world, {position(rng), position(rng)}, {speed(rng), speed(rng)}, radius(rng));
+            }
+            break;
+
+        case Scenario::Clustered:
+        {
+            // Eight blobs, four times as dense as the uniform scenario
+            std::array<sf::Vector2f, 8> centers;
+            for (auto& center : centers)
+            {
+                center = {position(rng), position(rng)};
+            }
+
+            std::normal_distribution spread(0.f, side / 16.f);
+            for (int i = 0; i < count; ++i)
+            {
+                const sf::Vector2f& center = centers[i % centers.size()];
+                SpawnBody(world, center + sf::Vector2f{spread(rng), spread(rng)}, {speed(rng), speed(rng)}, radius(rng));
+            }
+            break;
+        }
+
+        case Scenario::Resting:
+        {
+            // A grid of bodies that don't touch and don't move, they all fall asleep during the warmup
+            const int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(count))));
+            for (int i = 0; i < count; ++i)
+            {
+                const sf::Vector2f cell = {static_cast<float>(i % columns), static_cast<float>(i / columns)};
+                SpawnBody(world, cell * 20.f, {}, 6.f);
+            }
+            break;
+        }
+
+        case Scenario::Fast:
+            for (int i = 0; i < count; ++i)
+            {
+                const float a = angle(rng);
+                const sf::Vector2f velocity = sf::Vector2f{std::cos(a), std::sin(a)} * 3000.f;
+                SpawnBody(world, {position(rng), position(rng)}, velocity, radius(rng)).add<ContinuousCollision>();
+            }
+            break;
+    }
+}
+
+void Run(Benchmarks::Report& report, const Scenario scenario, const int count)
+{
+    flecs::world world;
+    world.import<Core::Modules::PhysicsModule>();
+
+    Populate(world, scenario, count);
+
+    // The systems are run one by one so the integration can be timed apart from the collision step
+    const std::array integration = {
+        Benchmarks::FindSystem<Core::Modules::PhysicsModule>(world, "GravitySystem"),
+        Benchmarks::FindSystem<Core::Modules::PhysicsModule>(world, "FrictionSystem"),
+        Benchmarks::FindSystem<Core::Modules::PhysicsModule>(world, "AccelerationSystem"),
+        Benchmarks::FindSystem<Core::Modules::PhysicsModule>(world, "MovementSystem"),
+    };
+    const flecs::system collision =
+        Benchmarks::FindSystem<Core::Modules::PhysicsModule>(world, "CircleCollisionSystem");
+
+    std::chrono::nanoseconds integrationTime{0};
+    std::chrono::nanoseconds broadphaseTime{0};
+    std::chrono::nanoseconds narrowphaseTime{0};
+
+    for (int step = 0; step < WARMUP_STEPS + MEASURED_STEPS; ++step)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (const flecs::system& system : integration)
+        {
+            system.run(DELTA_TIME);
+        }
+        const auto end = std::chrono::steady_clock::now();
+
+        collision.run(DELTA_TIME);
+
+        if (step >= WARMUP_STEPS)
+        {
+            const auto& stats = world.get<PhysicsStats>();
+            integrationTime += end - start;
+            broadphaseTime += stats.broadphaseTime;
+            narrowphaseTime += stats.narrowphaseTime;
+        }
+    }
+
+    const auto perBodyPerStep = [count](const std::chrono::nanoseconds time) {
+        return static_cast<double>(time.count()) / (static_cast<double>(count) * MEASURED_STEPS);
+    };
+
+    const std::string name = ToString(scenario);
+    report.Add(SUITE, name + " integration", count, perBodyPerStep(integrationTime), "ns/body/step");
+    report.Add(SUITE, name + " broadphase", count, perBodyPerStep(broadphaseTime), "ns/body/step");
+    report.Add(SUITE, name + " narrowphase", count, perBodyPerStep(narrowphaseTime), "ns/body/step");
+
+    const auto& stats = world.get<PhysicsStats>();
+    report.Add(SUITE, name + " awake bodies", count, stats.awakeBodies, "bodies");
+    report.Add(SUITE, name + " contacts", count, stats.contacts, "contacts");
+}
+
+} // namespace
+
+namespace Benchmarks
+{
+
+void RunPhysics(Report& report)
+{
+    for (const Scenario scenario : {Scenario::Uniform, Scenario::Clustered, Scenario::Resting, Scenario::Fast})
+    {
+        std::printf("Physics, %s\n", ToString(scenario));
+        for (const int count : {1'000, 10'000, 50'000})
+        {
+            Run(report, scenario, count);
+        }
+        std::printf("\n");
+    }
+}
+
+} // namespace Benchmarks
@@ -0,0 +1,35 @@
+// Copyright (c) Eric Jeker 2025.
+
+#include "Benchmarks.h"
+
+#include <fstream>
+
+namespace Benchmarks
+{
+
+void Report::Add(const std::string& suite, const std::string& name, const int entities, const double value,
+                 const std::string& unit)
+{
+    std::printf("  %-40s %8d %12.2f %s\n", name.c_str(), entities, value, unit.c_str());
+    _results.push_back({{"suite", suite}, {"name", name}, {"entities", entities}, {"value", value}, {"unit", unit}});
+}
+
+void Report::Fail(const std::string& suite, const std::string& message)
+{
+    std::fprintf(stderr, "  FAILED: %s\n", message.c_str());
+    _failures.push_back({{"suite", suite}, {"message", message}});
+}
+
+bool Report::WriteJson(const std::filesystem::path& path) const
+{
+    std::ofstream file(path);
+    if (!file)
+    {
+        return false;
+    }
+
+    file << nlohmann::json{{"results", _results}, {"failures", _failures}}.dump(2) << "\n";
+    return true;
+}
+
+} // namespace Benchmarks
@@ -0,0 +1,129 @@
+// Copyright (c) Eric Jeker 2025.
+
+#include "Benchmarks.h"
+
+#include "SFE/Modules/Physics/Components/CollisionFilter.h"
+#include "SFE/Modules/Physics/PhysicsModule.h"
+#include "SFE/Modules/Physics/Singletons/SpatialQuery.h"
+#include "SFE/Modules/Render/Components/Radius.h"
+#include "SFE/Modules/Render/Components/Size.h"
+#include "SFE/Modules/Render/Components/Transform.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+constexpr sf::Vector2f WORLD_SIZE = {4096.f, 4096.f};
+constexpr int QUERIES = 100'000;
+
+constexpr auto SUITE = "SpatialQuery";
+
+void RunWithEntityCount(Benchmarks::Report& report, const int count)
+{
+    std::printf("SpatialQuery, %d entities\n", count);
+
+    flecs::world world;
+    world.import<Core::Modules::PhysicsModule>();
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution x(0.f, WORLD_SIZE.x);
+    std::uniform_real_distribution y(0.f, WORLD_SIZE.y);
+    std::uniform_real_distribution extent(2.f, 16.f);
+
+    std::vector<flecs::entity> entities;
+    entities.reserve(count);
+    Benchmarks::Measure(report, SUITE, "Index (set Transform)", count, count, [&](const int i) {
+        auto e = world.entity().set<CollisionFilter>({}).set<Transform>({.position = {x(rng), y(rng)}});
+        if (i % 4 == 0)
+        {
+            e.set<Size>({.size = {extent(rng) * 2.f, extent(rng) * 2.f}});
+        }
+        else
+        {
+            e.set<Radius>({.radius = extent(rng)});
+        }
+        entities.push_back(e);
+    });
+
+    const auto& spatialQuery = world.get<SpatialQuery>();
+    report.Add(SUITE, "Tree height", count, spatialQuery.GetTree().GetHeight(), "levels");
+
+    // Pre-generate the inputs so the random generator is not measured
+    std::vector<sf::Vector2f> points(QUERIES);
+    std::vector<sf::Vector2f> directions(QUERIES);
+    std::uniform_real_distribution angle(0.f, 6.2831853f);
+    for (int i = 0; i < QUERIES; ++i)
+    {
+        points[i] = {x(rng), y(rng)};
+        const float a = angle(rng);
+        directions[i] = {std::cos(a), std::sin(a)};
+    }
+
+    std::size_t found = 0;
+    std::array<flecs::entity, 64> overlaps;
+    std::array<RaycastHit, 8> rayHits;
+    std::array<NearestHit, 8> nearest;
+
+    Benchmarks::Measure(report, SUITE, "OverlapPoint", count, QUERIES, [&](const int i) {
+        found += spatialQuery.OverlapPoint(points[i], overlaps);
+    });
+    Benchmarks::Measure(report, SUITE, "OverlapBox 128x128", count, QUERIES, [&](const int i) {
+        found += spatialQuery.OverlapBox({points[i], {128.f, 128.f}}, overlaps);
+    });
+    Benchmarks::Measure(report, SUITE, "Raycast closest, 512px", count, QUERIES, [&](const int i) {
+        found += spatialQuery.Raycast(points[i], directions[i], 512.f, std::span(rayHits).first(1));
+    });
+    Benchmarks::Measure(report, SUITE, "Raycast 8 hits, 512px", count, QUERIES, [&](const int i) {
+        found += spatialQuery.Raycast(points[i], directions[i], 512.f, rayHits);
+    });
+    Benchmarks::Measure(report, SUITE, "Nearest k=8", count, QUERIES, [&](const int i) {
+        found += spatialQuery.Nearest(points[i], nearest);
+    });
+
+    // What the spatial query replaces: testing every entity
+    const int bruteForceQueries = std::max(1, QUERIES / count);
+    Benchmarks::Measure(report, SUITE, "Brute force OverlapBox 128x128", count, bruteForceQueries, [&](const int i) {
+        const sf::FloatRect box = {points[i], {128.f, 128.f}};
+        world.each([&](const Transform& t, const Radius& r) {
+            const float dx = std::clamp(t.position.x, box.position.x, box.position.x + box.size.x) - t.position.x;
+            const float dy = std::clamp(t.position.y, box.position.y, box.position.y + box.size.y) - t.position.y;
+            found += dx * dx + dy * dy <= r.radius * r.radius;
+        });
+    });
+
+    // Incremental refit, most moves stay inside the fat AABB and never touch the tree
+    auto& mutableQuery = world.get_mut<SpatialQuery>();
+    std::uniform_real_distribution step(-2.f, 2.f);
+    std::vector<sf::Vector2f> positions(count);
+    for (int i = 0; i < count; ++i)
+    {
+        positions[i] = entities[i].get<Transform>().position;
+    }
+    Benchmarks::Measure(report, SUITE, "Refit, small moves (per body)", count, count * 10, [&](const int i) {
+        const int index = i % count;
+        positions[index] += {step(rng), step(rng)};
+        mutableQuery.Move(entities[index].id(), positions[index]);
+    });
+
+    std::printf("  (%zu results)\n\n", found);
+}
+
+} // namespace
+
+namespace Benchmarks
+{
+
+void RunSpatialQuery(Report& report)
+{
+    for (const int count : {1'000, 10'000, 100'000})
+    {
+        RunWithEntityCount(report, count);
+    }
+}
+
+} // namespace Benchmarks
@@ -6,8 +6,10 @@
 #include "SFE/GameService.h"
 #include "SFE/Managers/GameStateManager.h"
 #include "SFE/Managers/SceneManager.h"
-#include "SFE/Modules/Input/Components/Command.h"
-#include "SFE/Modules/Lifetime/Components/LifetimeOneFrame.h"
+#include "SFE/Modules/Event/EventBus.h"
+#include "SFE/Modules/Input/Singletons/InputSnapshot.h"
+#include "SFE/Modules/Lifetime/Singletons/EntityPool.h"
+#include "SFE/Modules/Physics/Singletons/DeterministicMode.h"
 #include "SFE/Modules/UI/Components/KeyPressed.h"
 #include "SFE/Modules/UI/Components/MouseReleased.h"
 #include "SFE/Modules/UI/Prefabs/FocusLostEvent.h"
@@ -16,19 +18,23 @@
 #include "SFE/Modules/Window/Components/DeferredEvent.h"
 #include "SFE/Modules/Window/Components/WindowResizeIntent.h"
 #include "SFE/Modules/Window/Singletons/FrameCount.h"
+#include "SFE/Modules/Window/Singletons/Headless.h"
 #include "SFE/Modules/Window/Singletons/WindowSize.h"
 #include "SFE/Utils/Logger.h"
 
 #include <tracy/Tracy.hpp>
 
+#include <cassert>
+
 void GameInstance::Initialize()
 {
     ZoneScopedN("GameInstance::Initialize");
 
-    const auto& window = GameService::Get<sf::RenderWindow>();
-
-    // --- Set the initial window size used when resizing ---
-    GetWorld().set<WindowSize>({.currentSize = window.getSize(), .refSize = Configuration::RESOLUTION});
+    // --- Set the initial window size used when resizing, a headless run has no window and keeps the reference size ---
+    const sf::Vector2u currentSize = GameService::Has<sf::RenderWindow>()
+                                         ? GameService::Get<sf::RenderWindow>().getSize()
+                                         : Configuration::RESOLUTION;
+    GetWorld().set<WindowSize>({.currentSize = currentSize, .refSize = Configuration::RESOLUTION});
 }
 
 void GameInstance::Run(sf::RenderWindow& renderWindow)
@@ -45,7 +51,23 @@ void GameInstance::Run(sf::RenderWindow& renderWindow)
         static int frameCount = 0;
         world.set<FrameCount>({frameCount++});
 
-        const float deltaTime = clock.restart().asSeconds();
+        float deltaTime = clock.restart().asSeconds();
+
+        // --- A deterministic run must not depend on how long the frames took ---
+        if (const auto* deterministic = world.try_get<DeterministicMode>(); deterministic != nullptr && deterministic->enabled)
+        {
+            deltaTime = deterministic->fixedDeltaTime;
+        }
+
+        // --- A replay goes at the pace of its recording and ends with it ---
+        if (_replay)
+        {
+            if (!_replay->NextFrame())
+            {
+                break;
+            }
+            deltaTime = _replay->GetDeltaTime();
+        }
 
         // --- Event-Based Input System---
         HandleEvents(renderWindow);
@@ -55,6 +77,13 @@ void GameInstance::Run(sf::RenderWindow& renderWindow)
         world.progress(deltaTime);
         renderWindow.display();
 
+        // --- The snapshot has been updated by the frame, it is recorded with the events and the delta time ---
+        if (_recorder)
+        {
+            const auto* snapshot = world.try_get<InputSnapshot>();
+            _recorder->EndFrame(snapshot != nullptr ? *snapshot : InputSnapshot(), deltaTime);
+        }
+
         // --- Process deferred events at the end of the frame ---
         RunDeferredEvents(world);
 
@@ -69,70 +98,167 @@ void GameInstance::Run(sf::RenderWindow& renderWindow)
     }
 }
 
+void GameInstance::RunHeadless()
+{
+    ZoneScopedN("GameInstance::RunHeadless");
+
+    assert(_replay && "GameInstance::RunHeadless: there is no replay, call StartReplay first.");
+    flecs::world& world = GetWorld();
+
+    // --- The systems using the window skip, there might be no window at all ---
+    world.add<Headless>();
+
+    int frameCount = 0;
+    while (!ShouldExit() && _replay->NextFrame())
+    {
+        world.set<FrameCount>({frameCount++});
+
+        ReplayEvents();
+        world.progress(_replay->GetDeltaTime());
+        RunDeferredEvents(world);
+
+        FrameMark;
+    }
+
+    world.remove<Headless>();
+}
+
+bool GameInstance::StartRecording(const std::filesystem::path& path)
+{
+    _recorder = std::make_unique<InputRecorder>(path);
+    if (!_recorder->IsOpen())
+    {
+        LOG_ERROR("GameInstance::StartRecording -> Cannot write {}", path.string());
+        _recorder.reset();
+        return false;
+    }
+    return true;
+}
+
+bool GameInstance::StartReplay(const std::filesystem::path& path)
+{
+    _replay = std::make_unique<InputReplay>(path);
+    if (!_replay->IsOpen())
+    {
+        LOG_ERROR("GameInstance::StartReplay -> Cannot read the recording {}", path.string());
+        _replay.reset();
+        return false;
+    }
+    return true;
+}
+
 void GameInstance::HandleEvents(sf::RenderWindow& renderWindow) const
 {
     ZoneScopedN("GameInstance::HandleEvents");
 
-    const auto& world = GetWorld();
-
     while (const auto event = renderWindow.pollEvent())
     {
         if (event->is<sf::Event::Closed>())
         {
             renderWindow.close();
+            continue;
         }
-        else if (const auto* resized = event->getIf<sf::Event::Resized>())
-        {
-            // TODO: Might as well move all this jazz in its own function
-            assert(world.has<WindowSize>() && "WindowSize singleton does not exist.");
-            auto& [size, refSize] = world.get_mut<WindowSize>();
-
-            // Calculate the scale of the new window size
-            assert(refSize.x > 0 && refSize.y > 0 && "Reference size must be greater than 0.");
-            const sf::Vector2f scale =
-                {static_cast<float>(resized->size.x) / static_cast<float>(refSize.x),
-                 static_cast<float>(resized->size.y) / static_cast<float>(refSize.y)};
-            const float scaleRatio = std::min(scale.x, scale.y);
-
-            // Calculate transformation to center (letterboxing or pillarboxing)
-            const sf::Vector2f transformRatio =
-                {(static_cast<float>(resized->size.x) - static_cast<float>(refSize.x) * scaleRatio) / 2.f,
-                 (static_cast<float>(resized->size.y) - static_cast<float>(refSize.y) * scaleRatio) / 2.f};
-
-            world.entity().add<LifetimeOneFrame>().add<Command>().set<WindowResizeIntent>({
-                .newSize = resized->size,
-                .oldSize = size,
-                .scaleRatio = scaleRatio,
-                .transformRatio = transformRatio,
-            });
-
-            size = resized->size;
-        }
-        else if (event->is<sf::Event::FocusLost>())
-        {
-            // It's up to the game to handle a focus-lost event, we just log it here
-            world.entity().is_a<Prefabs::FocusLostEvent>();
-        }
-        else if (const auto* keyPressed = event->getIf<sf::Event::KeyPressed>())
+
+        // During a replay the window can only be closed, the input comes from the recording
+        if (_replay)
         {
-            LOG_DEBUG("GameInstance::HandleEvent -> KeyPressed");
-            // We log all the key pressed events, the game will later handle them
-            world.entity().is_a<Prefabs::KeyPressedEvent>().set<KeyPressed>({
-                .code = keyPressed->code,
-                .scancode = keyPressed->scancode,
-                .alt = keyPressed->alt,
-                .control = keyPressed->control,
-                .shift = keyPressed->shift,
-            });
+            continue;
         }
-        else if (const auto* mouseReleased = event->getIf<sf::Event::MouseButtonReleased>())
+
+        if (_recorder)
         {
-            LOG_DEBUG("GameInstance::HandleEvent -> MouseButtonReleased");
-            // Same here for the mouse events
-            world.entity().is_a<Prefabs::MouseReleasedEvent>().set<MouseReleased>(
-                {.position = mouseReleased->position, .button = mouseReleased->button}
-            );
+            _recorder->RecordEvent(*event);
         }
+        HandleEvent(*event);
+    }
+
+    if (_replay)
+    {
+        ReplayEvents();
+    }
+}
+
+void GameInstance::ReplayEvents() const
+{
+    for (const sf::Event& event : _replay->GetEvents())
+    {
+        HandleEvent(event);
+    }
+
+    if (auto* snapshot = GetWorld().try_get_mut<InputSnapshot>())
+    {
+        _replay->ApplyTo(*snapshot);
+    }
+}
+
+void GameInstance::HandleEvent(const sf::Event& event) const
+{
+    const auto& world = GetWorld();
+
+    // The keyboard and mouse states of the input snapshot follow the events, when the InputModule is imported
+    if (auto* snapshot = world.try_get_mut<InputSnapshot>())
+    {
+        snapshot->Apply(event);
+    }
+
+    // The event entities are pooled, they are released at the end of the frame and reused by the next events
+    assert(world.has<EntityPool>() && "EntityPool singleton does not exist, import the LifetimeModule.");
+    auto& pool = world.get_mut<EntityPool>();
+
+    if (const auto* resized = event.getIf<sf::Event::Resized>())
+    {
+        // TODO: Might as well move all this jazz in its own function
+        assert(world.has<WindowSize>() && "WindowSize singleton does not exist.");
+        auto& [size, refSize] = world.get_mut<WindowSize>();
+
+        // Calculate the scale of the new window size
+        assert(refSize.x > 0 && refSize.y > 0 && "Reference size must be greater than 0.");
+        const sf::Vector2f scale =
+            {static_cast<float>(resized->size.x) / static_cast<float>(refSize.x),
+             static_cast<float>(resized->size.y) / static_cast<float>(refSize.y)};
+        const float scaleRatio = std::min(scale.x, scale.y);
+
+        // Calculate transformation to center (letterboxing or pillarboxing)
+        const sf::Vector2f transformRatio =
+            {(static_cast<float>(resized->size.x) - static_cast<float>(refSize.x) * scaleRatio) / 2.f,
+             (static_cast<float>(resized->size.y) - static_cast<float>(refSize.y) * scaleRatio) / 2.f};
+
+        const WindowResizeIntent intent = {
+            .newSize = resized->size,
+            .oldSize = size,
+            .scaleRatio = scaleRatio,
+            .transformRatio = transformRatio,
+        };
+        // Outside of the systems the observers run right away, they read the new size from the singleton
+        size = resized->size;
+        Events::Emit(world, intent);
+    }
+    else if (event.is<sf::Event::FocusLost>())
+    {
+        // It's up to the game to handle a focus-lost event, we just log it here
+        pool.Acquire(world, world.entity<Prefabs::FocusLostEvent>());
+    }
+    else if (const auto* keyPressed = event.getIf<sf::Event::KeyPressed>())
+    {
+        LOG_DEBUG("GameInstance::HandleEvent -> KeyPressed");
+        // The key pressed events go on the bus, and stay entities for the games still querying them
+        const KeyPressed pressed = {
+            .code = keyPressed->code,
+            .scancode = keyPressed->scancode,
+            .alt = keyPressed->alt,
+            .control = keyPressed->control,
+            .shift = keyPressed->shift,
+        };
+        Events::Emit(world, pressed);
+        pool.Acquire(world, world.entity<Prefabs::KeyPressedEvent>()).set<KeyPressed>(pressed);
+    }
+    else if (const auto* mouseReleased = event.getIf<sf::Event::MouseButtonReleased>())
+    {
+        LOG_DEBUG("GameInstance::HandleEvent -> MouseButtonReleased");
+        // Same here for the mouse events
+        const MouseReleased released = {.position = mouseReleased->position, .button = mouseReleased->button};
+        Events::Emit(world, released);
+        pool.Acquire(world, world.entity<Prefabs::MouseReleasedEvent>()).set<MouseReleased>(released);
     }
 }
 
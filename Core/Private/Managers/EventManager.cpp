@@ -2,18 +2,119 @@
 
 #include "SFE/Managers/EventManager.h"
 
-void EventManager::ProcessDeferredEvents()
+#include <atomic>
+
+namespace
+{
+
+std::atomic<std::uint64_t> nextSerial = 1;
+
+} // namespace
+
+EventManager::EventManager()
+    : _ownerThread(std::this_thread::get_id())
+    , _serial(nextSerial.fetch_add(1, std::memory_order_relaxed))
+    , _producers(std::make_unique<ProducerRegistry>())
+{
+}
+
+std::uint32_t EventManager::NextTypeId()
+{
+    // Types can be seen for the first time from a producer thread
+    static std::atomic<std::uint32_t> nextId = 0;
+    return nextId.fetch_add(1, std::memory_order_relaxed);
+}
+
+void EventManager::Unsubscribe(EventSubscription& subscription)
+{
+    if (subscription.IsValid())
+    {
+        if (subscription.batch && subscription.type < _batchListeners.size())
+        {
+            RemoveListener(_batchListeners[subscription.type], subscription);
+        }
+        else if (!subscription.batch && subscription.type < _listeners.size())
+        {
+            RemoveListener(_listeners[subscription.type], subscription);
+        }
+    }
+
+    subscription = {};
+}
+
+EventManager::DeferredBuffers& EventManager::GetProducerBuffers()
 {
-    // Process all deferred events
-    for (auto& deferredEvent : _deferredEvents)
+    struct ProducerCache
+    {
+        std::uint64_t serial = 0;
+        DeferredBuffers* buffers = nullptr;
+    };
+    thread_local ProducerCache cache;
+
+    if (cache.serial == _serial)
     {
-        LOG_DEBUG(
-            "(EventManager::ProcessDeferredEvents: Processing deferred event: " +
-            std::string(deferredEvent.eventType.name())
-        );
-        deferredEvent.eventExecutor();
+        return *cache.buffers;
     }
 
-    // Clear the deferred events after processing
-    _deferredEvents.clear();
+    std::scoped_lock lock(_producers->mutex);
+    const std::thread::id thread = std::this_thread::get_id();
+
+    DeferredBuffers* buffers = nullptr;
+    for (const Producer& producer : _producers->producers)
+    {
+        if (producer.thread == thread)
+        {
+            buffers = producer.buffers.get();
+            break;
+        }
+    }
+    if (!buffers)
+    {
+        buffers = _producers->producers.emplace_back(thread, std::make_unique<DeferredBuffers>()).buffers.get();
+    }
+
+    cache = {_serial, buffers};
+    return *buffers;
+}
+
+void EventManager::MergeProducers()
+{
+    // The lock only guards against a thread registering now, the buffers themselves must not be written meanwhile
+    std::scoped_lock lock(_producers->mutex);
+    for (const Producer& producer : _producers->producers)
+    {
+        DeferredBuffers& buffers = *producer.buffers;
+        for (const std::uint32_t type : buffers.pendingTypes)
+        {
+            DeferredQueueBase& source = *buffers.queues[type];
+            if (type >= _deferred.queues.size())
+            {
+                _deferred.queues.resize(type + 1);
+            }
+
+            std::unique_ptr<DeferredQueueBase>& target = _deferred.queues[type];
+            if (!target)
+            {
+                target = source.CreateEmpty();
+            }
+            if (!target->HasPending())
+            {
+                _deferred.pendingTypes.push_back(type);
+            }
+            source.MergeInto(*target);
+        }
+        buffers.pendingTypes.clear();
+    }
+}
+
+void EventManager::ProcessDeferredEvents()
+{
+    MergeProducers();
+
+    std::swap(_deferred.pendingTypes, _dispatchingTypes);
+    for (const std::uint32_t type : _dispatchingTypes)
+    {
+        _deferred.queues[type]->Dispatch(*this);
+    }
+    _dispatchingTypes.clear();
 }
@@ -6,7 +6,9 @@
 #include "SFE/Modules/Camera/Components/CameraShake.h"
 #include "SFE/Modules/Camera/Components/CameraShakeIntent.h"
 #include "SFE/Modules/Camera/Singletons/MainCamera.h"
+#include "SFE/Modules/Event/EventBus.h"
 #include "SFE/Modules/Window/Components/WindowResizeIntent.h"
+#include "SFE/Modules/Window/Singletons/Headless.h"
 #include "SFE/Modules/Window/Singletons/WindowSize.h"
 #include "SFE/Utils/Logger.h"
 
@@ -123,10 +125,13 @@ CameraModule::CameraModule(const flecs::world& world)
     world.set<MainCamera>({.view = std::move(cameraView)});
 
     // --- Declare Systems ---
-    world.system<const WindowResizeIntent>("UpdateViewport").kind(flecs::PostLoad).each(UpdateViewport);
+    Events::Subscribe<WindowResizeIntent>(world, UpdateViewport);
     world.system<const CameraShakeIntent>("ProcessCameraShakeIntent").each(ProcessCameraShakeIntent);
     world.system("ApplyCameraToWindow").kind(flecs::PreStore).run([](const flecs::iter& i) {
-        GameService::Get<sf::RenderWindow>().setView(i.world().get<MainCamera>().view);
+        if (!i.world().has<Headless>())
+        {
+            GameService::Get<sf::RenderWindow>().setView(i.world().get<MainCamera>().view);
+        }
     });
     world.system<CameraShake>("UpdateCameraShake").kind(flecs::PreStore).each(UpdateCameraShake);
 }
@@ -0,0 +1,71 @@
+// Copyright (c) Eric Jeker 2025.
+
+#include "SFE/Modules/Event/EventArena.h"
+
+#include "SFE/Modules/Event/EventBus.h"
+
+#include <algorithm>
+#include <cstdint>
+
+void EventArena::Flush(const flecs::world& world)
+{
+    if (_pending.empty())
+    {
+        return;
+    }
+
+    const flecs::entity bus = world.entity<EventBus>();
+
+    // By index, the observers may queue more events while we go
+    for (std::size_t i = 0; i < _pending.size(); ++i)
+    {
+        const Pending pending = _pending[i];
+        pending.emit(bus, pending.payload);
+    }
+    _pending.clear();
+}
+
+void EventArena::Reset()
+{
+    _pending.clear();
+    _block = 0;
+    _offset = 0;
+    _bytesUsed = 0;
+}
+
+std::size_t EventArena::GetPendingCount() const
+{
+    return _pending.size();
+}
+
+std::size_t EventArena::GetBytesUsed() const
+{
+    return _bytesUsed;
+}
+
+void* EventArena::Allocate(const std::size_t size, const std::size_t alignment)
+{
+    while (true)
+    {
+        if (_block == _blocks.size())
+        {
+            // Payloads larger than a block get a block of their own
+            const std::size_t blockSize = std::max(BLOCK_SIZE, size + alignment);
+            _blocks.push_back(std::make_unique<std::byte[]>(blockSize));
+            _blockSizes.push_back(blockSize);
+        }
+
+        const auto base = reinterpret_cast<std::uintptr_t>(_blocks[_block].get());
+        const std::size_t offset = (base + _offset + alignment - 1) / alignment * alignment - base;
+        if (offset + size <= _blockSizes[_block])
+        {
+            _offset = offset + size;
+            _bytesUsed += size;
+            return _blocks[_block].get() + offset;
+        }
+
+        // The block is full, the next one is reused or created
+        ++_block;
+        _offset = 0;
+    }
+}
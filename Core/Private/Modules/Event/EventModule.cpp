@@ -2,7 +2,11 @@
 
 #include "SFE/Modules/Event/EventModule.h"
 
+#include "SFE/Managers/EventManager.h"
 #include "SFE/Modules/Event/Components/EventBindings.h"
+#include "SFE/Modules/Event/EventArena.h"
+#include "SFE/Modules/Event/EventBus.h"
+#include "SFE/Modules/Event/Singletons/SceneBindingStack.h"
 #include "SFE/Modules/Input/Components/Command.h"
 #include "SFE/Modules/Lifetime/Components/LifetimeOneFrame.h"
 #include "SFE/Modules/Scene/Components/SceneDepth.h"
@@ -11,49 +15,40 @@
 #include "SFE/Modules/UI/Components/KeyPressed.h"
 #include "SFE/Utils/Logger.h"
 
-#include <algorithm>
-#include <ranges>
-
 namespace
 {
 
 auto ProcessKeyPressedEvents()
 {
     return [](const flecs::entity& e, const KeyPressed& k) {
-        // Generate the event key
-        const auto eventKey = InputKey::Keyboard(k.code);
-
-        const auto sceneQuery = e.world()
-                                    .query_builder<const SceneDepth, EventBindings>()
-                                    .with<SceneRoot>()
-                                    .without<ScenePaused>()
-                                    .build();
-
-        // Collect entities and sort manually
-        std::vector<std::pair<flecs::entity, SceneDepth>> entities;
-        sceneQuery.each([&entities](const flecs::entity& rootEntity, const SceneDepth& depth, EventBindings&) {
-            entities.emplace_back(rootEntity, depth);
-        });
-
-        // Sort by depth
-        std::ranges::sort(entities, [](const auto& a, const auto& b) { return a.second.depth > b.second.depth; });
-
-        // Process sorted entities
-        for (const auto& rootEntity : entities | std::views::keys)
+        auto& stack = e.world().get_mut<SceneBindingStack>();
+        if (stack.IsDirty())
         {
-            auto [map] = rootEntity.get<EventBindings>();
-            if (!map.contains(eventKey))
-            {
-                return;
-            }
-
-            LOG_DEBUG("EventModule::ProcessKeyPressedEvents -> Processing event for scene {} -> {}", std::string(rootEntity.name()), rootEntity.id());
-            rootEntity.world().entity().is_a(map[eventKey]);
-            break;
+            stack.Rebuild(e.world());
         }
+
+        const flecs::entity binding = stack.Resolve(k.code);
+        if (!binding)
+        {
+            return;
+        }
+
+        LOG_DEBUG("EventModule::ProcessKeyPressedEvents -> Processing event for binding {}", binding.id());
+        e.world().entity().is_a(binding);
     };
 }
 
+/**
+ * @brief Flags the binding stack for a rebuild when a scene loads, unloads, pauses or changes its bindings.
+ */
+void InvalidateSceneBindings(const flecs::entity& e)
+{
+    if (auto* stack = e.world().try_get_mut<SceneBindingStack>())
+    {
+        stack->Invalidate();
+    }
+}
+
 } // namespace
 
 
@@ -63,8 +58,52 @@ namespace Core::Modules
 EventModule::EventModule(const flecs::world& world)
 {
     world.component<EventBindings>();
-
-    world.system<const KeyPressed>("EventModule::ProcessKeyPressedEvents").kind(flecs::PostLoad).each(ProcessKeyPressedEvents());
+    world.component<EventBus>();
+    world.component<EventArena>();
+    world.component<EventManager>();
+    world.component<SceneBindingStack>();
+
+    world.set<EventArena>(EventArena());
+    world.set<EventManager>(EventManager());
+    world.set<SceneBindingStack>(SceneBindingStack());
+
+    world.observer("EventModule::InvalidateOnBindings")
+        .with<EventBindings>()
+        .event(flecs::OnSet)
+        .event(flecs::OnRemove)
+        .each(InvalidateSceneBindings);
+    world.observer("EventModule::InvalidateOnDepth")
+        .with<SceneDepth>()
+        .event(flecs::OnSet)
+        .event(flecs::OnRemove)
+        .each(InvalidateSceneBindings);
+    world.observer("EventModule::InvalidateOnRoot")
+        .with<SceneRoot>()
+        .event(flecs::OnAdd)
+        .event(flecs::OnRemove)
+        .each(InvalidateSceneBindings);
+    world.observer("EventModule::InvalidateOnPause")
+        .with<ScenePaused>()
+        .event(flecs::OnAdd)
+        .event(flecs::OnRemove)
+        .each(InvalidateSceneBindings);
+
+    // The events emitted from the systems are dispatched before the update, then the late ones at the end of frame
+    world.system("EventModule::FlushEvents").immediate().kind(flecs::PreUpdate).run([](const flecs::iter& it) {
+        it.world().get_mut<EventArena>().Flush(it.world());
+    });
+    world.system("EventModule::ResetEventArena").immediate().kind(flecs::PostFrame).run([](const flecs::iter& it) {
+        auto& arena = it.world().get_mut<EventArena>();
+        arena.Flush(it.world());
+        arena.Reset();
+    });
+
+    // Deferred EventManager events, like damage ticks and collisions, are flushed once the simulation is done
+    world.system("EventModule::ProcessDeferredEvents").immediate().kind(flecs::PostUpdate).run([](const flecs::iter& it) {
+        it.world().get_mut<EventManager>().ProcessDeferredEvents();
+    });
+
+    Events::Subscribe<KeyPressed>(world, ProcessKeyPressedEvents());
 }
 
 } // namespace Core::Modules
@@ -0,0 +1,77 @@
+// Copyright (c) Eric Jeker 2025.
+
+#include "SFE/Modules/Event/Singletons/SceneBindingStack.h"
+
+#include "SFE/Modules/Event/Components/EventBindings.h"
+#include "SFE/Modules/Scene/Components/SceneDepth.h"
+#include "SFE/Modules/Scene/Tags/ScenePaused.h"
+#include "SFE/Modules/Scene/Tags/SceneRoot.h"
+
+#include <algorithm>
+#include <ranges>
+#include <tracy/Tracy.hpp>
+
+void SceneBindingStack::Rebuild(const flecs::world& world)
+{
+    ZoneScopedN("SceneBindingStack::Rebuild");
+
+    std::vector<std::pair<int, const EventBindings*>> scenes;
+    world.query_builder<const SceneDepth, const EventBindings>()
+        .with<SceneRoot>()
+        .without<ScenePaused>()
+        .build()
+        .each([&scenes](const SceneDepth& depth, const EventBindings& bindings) {
+            scenes.emplace_back(depth.depth, &bindings);
+        });
+
+    // Deepest scene first, so the first binding found for a key is the one that wins
+    std::ranges::stable_sort(scenes, [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    _keyboard.fill(flecs::entity::null());
+    _others.clear();
+    for (const EventBindings* bindings : scenes | std::views::values)
+    {
+        for (const auto& [key, binding] : bindings->map)
+        {
+            if (const auto* keyboard = std::get_if<InputKey::Key>(&key.id))
+            {
+                const auto index = static_cast<std::size_t>(keyboard->code);
+                if (index < _keyboard.size() && !_keyboard[index])
+                {
+                    _keyboard[index] = binding;
+                }
+            }
+            else if (std::ranges::find(_others, key.id, &decltype(_others)::value_type::first) == _others.end())
+            {
+                _others.emplace_back(key.id, binding);
+            }
+        }
+    }
+
+    _sceneCount = scenes.size();
+    _dirty = false;
+}
+
+flecs::entity SceneBindingStack::Resolve(const sf::Keyboard::Key key) const
+{
+    // Unknown is -1 and wraps past the end of the table
+    const auto index = static_cast<std::size_t>(key);
+    return index < _keyboard.size() ? _keyboard[index] : flecs::entity::null();
+}
+
+flecs::entity SceneBindingStack::Resolve(const InputKey& key) const
+{
+    if (const auto* keyboard = std::get_if<InputKey::Key>(&key.id))
+    {
+        return Resolve(keyboard->code);
+    }
+
+    for (const auto& [id, binding] : _others)
+    {
+        if (id == key.id)
+        {
+            return binding;
+        }
+    }
+    return flecs::entity::null();
+}
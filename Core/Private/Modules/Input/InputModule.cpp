@@ -6,7 +6,35 @@
 #include "SFE/Modules/Input/Components/PossessedByPlayer.h"
 #include "SFE/Modules/Input/Components/Target.h"
 #include "SFE/Modules/Input/Singletons/InputBindings.h"
+#include "SFE/Modules/Input/Singletons/InputSnapshot.h"
 #include "SFE/Modules/Lifetime/Components/LifetimeOneFrame.h"
+#include "SFE/Modules/Lifetime/Singletons/EntityPool.h"
+
+#include <cassert>
+
+namespace
+{
+
+/**
+ * Resolves the bindings to snapshot controls once, instead of asking SFML for each binding every frame.
+ */
+void CompileBindings(InputBindings& bindings, InputSnapshot& snapshot)
+{
+    snapshot.ClearAxisControls();
+
+    bindings.compiled.clear();
+    for (const auto& [inputKey, prefab] : bindings.GetMap())
+    {
+        const InputSnapshot::Control control = snapshot.Compile(inputKey);
+        if (control != InputSnapshot::INVALID_CONTROL)
+        {
+            bindings.compiled.push_back({control, prefab});
+        }
+    }
+    bindings.compiledVersion = bindings.GetVersion();
+}
+
+} // namespace
 
 namespace Core::Modules
 {
@@ -14,28 +42,52 @@ namespace Core::Modules
 InputModule::InputModule(const flecs::world& world)
 {
     world.component<PossessedByPlayer>();
-    world.component<Command>();
+    // The commands are pooled, a released one is hidden by toggling these off
+    world.component<Command>().add(flecs::CanToggle);
+    world.component<Target>().add(flecs::CanToggle);
+    world.component<InputSnapshot>();
 
     world.singleton<InputBindings>();
+    world.set<InputSnapshot>(InputSnapshot());
 
-    world.system<const InputBindings>("InputSystem")
+    // The bindings set or rebound since the last frame are compiled before the update, so the controls they add are
+    // sampled this frame already
+    world.system<InputSnapshot, InputBindings>("InputModule::UpdateSnapshot")
         .term_at(0)
         .singleton()
+        .term_at(1)
+        .singleton()
+        .kind(flecs::OnLoad)
+        .each([](InputSnapshot& snapshot, InputBindings& b) {
+            if (b.compiledVersion != b.GetVersion())
+            {
+                CompileBindings(b, snapshot);
+            }
+            snapshot.Update();
+        });
+
+    const auto possessed = world.query<const PossessedByPlayer>();
+    world.system<const InputBindings, const InputSnapshot>("InputSystem")
+        .term_at(0)
+        .singleton()
+        .term_at(1)
+        .singleton()
         .kind(flecs::PostLoad)
         // If we don't specify we write commands then we risk having a frame lag
         .write<Command>()
-        .each([&](const flecs::iter& it, size_t, const InputBindings& b) {
-            // Query the player currently possessed
-            const auto q = it.world().query<const PossessedByPlayer>();
-            if (q.count() == 0)
+        .each([possessed](const flecs::iter& it, size_t, const InputBindings& b, const InputSnapshot& snapshot) {
+            if (possessed.count() == 0)
             {
                 return;
             }
 
-            // Loop each binding to see if the input is activated
-            for (const auto& [inputKey, prefab] : b.map)
+            assert(it.world().has<EntityPool>() && "EntityPool singleton does not exist, import the LifetimeModule.");
+            auto& pool = it.world().get_mut<EntityPool>();
+
+            // Loop each binding to see if the input is held this frame
+            for (const auto& [control, prefab] : b.compiled)
             {
-                if (!inputKey.isActivated())
+                if (!snapshot.IsHeld(control))
                 {
                     continue;
                 }
@@ -43,8 +95,9 @@ InputModule::InputModule(const flecs::world& world)
                 // TODO:
                 //   - Add the Command as child_of the entity
                 //   - Add a Seq number to guarantee the sequence of commands
-                q.each([&](flecs::entity e, const PossessedByPlayer& p) {
-                    it.world().entity().is_a(prefab).add<LifetimeOneFrame>().add<Command>().add<Target>().set<Target>({e});
+                // The commands are pooled, the adds only move the entity the first time it is created
+                possessed.each([&](flecs::entity e, const PossessedByPlayer& p) {
+                    pool.Acquire(it.world(), prefab).add<LifetimeOneFrame>().add<Command>().set<Target>({e});
                 });
             }
         });
@@ -0,0 +1,359 @@
+// Copyright (c) Eric Jeker 2025.
+
+#include "SFE/Modules/Input/InputRecording.h"
+
+#include <array>
+#include <bit>
+#include <tracy/Tracy.hpp>
+
+namespace
+{
+
+constexpr std::array<char, 4> MAGIC = {'S', 'F', 'E', 'I'};
+constexpr std::uint64_t VERSION = 2;
+
+enum class RecordedEvent : std::uint8_t
+{
+    Resized,
+    FocusLost,
+    FocusGained,
+    KeyPressed,
+    KeyReleased,
+    MouseButtonPressed,
+    MouseButtonReleased
+};
+
+void WriteByte(std::vector<std::uint8_t>& out, const std::uint8_t value)
+{
+    out.push_back(value);
+}
+
+void WriteVarint(std::vector<std::uint8_t>& out, std::uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<std::uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+/** @brief Zigzag encoding, so small negative numbers stay short too. */
+void WriteSigned(std::vector<std::uint8_t>& out, const std::int64_t value)
+{
+    WriteVarint(out, (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+}
+
+void WriteFloat(std::vector<std::uint8_t>& out, const float value)
+{
+    const auto bits = std::bit_cast<std::uint32_t>(value);
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        out.push_back(static_cast<std::uint8_t>(bits >> shift));
+    }
+}
+
+/**
+ * @brief Reads the values written by the Write functions, any read past the end of the stream clears ok.
+ */
+struct Reader
+{
+    std::istream& in;
+    bool ok = true;
+
+    std::uint8_t Byte()
+    {
+        const auto value = in.get();
+        if (value == std::istream::traits_type::eof())
+        {
+            ok = false;
+            return 0;
+        }
+        return static_cast<std::uint8_t>(value);
+    }
+
+    std::uint64_t Varint()
+    {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64 && ok; shift += 7)
+        {
+            const std::uint8_t byte = Byte();
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return value;
+            }
+        }
+        ok = false;
+        return 0;
+    }
+
+    std::int64_t Signed()
+    {
+        const std::uint64_t value = Varint();
+        return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+    }
+
+    float Float()
+    {
+        std::uint32_t bits = 0;
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            bits |= static_cast<std::uint32_t>(Byte()) << shift;
+        }
+        return std::bit_cast<float>(bits);
+    }
+};
+
+template <typename T>
+void WriteKey(std::vector<std::uint8_t>& out, const RecordedEvent type, const T& key)
+{
+    WriteByte(out, static_cast<std::uint8_t>(type));
+    WriteSigned(out, static_cast<std::int64_t>(key.code));
+    WriteSigned(out, static_cast<std::int64_t>(key.scancode));
+    WriteByte(out, static_cast<std::uint8_t>(key.alt | key.control << 1 | key.shift << 2 | key.system << 3));
+}
+
+template <typename T>
+T ReadKey(Reader& reader)
+{
+    T key{};
+    key.code = static_cast<sf::Keyboard::Key>(reader.Signed());
+    key.scancode = static_cast<sf::Keyboard::Scancode>(reader.Signed());
+    const std::uint8_t modifiers = reader.Byte();
+    key.alt = (modifiers & 1) != 0;
+    key.control = (modifiers & 2) != 0;
+    key.shift = (modifiers & 4) != 0;
+    key.system = (modifiers & 8) != 0;
+    return key;
+}
+
+template <typename T>
+void WriteMouseButton(std::vector<std::uint8_t>& out, const RecordedEvent type, const T& mouse, sf::Vector2i& last)
+{
+    WriteByte(out, static_cast<std::uint8_t>(type));
+    WriteByte(out, static_cast<std::uint8_t>(mouse.button));
+    WriteSigned(out, mouse.position.x - last.x);
+    WriteSigned(out, mouse.position.y - last.y);
+    last = mouse.position;
+}
+
+template <typename T>
+T ReadMouseButton(Reader& reader, sf::Vector2i& last)
+{
+    T mouse{};
+    mouse.button = static_cast<sf::Mouse::Button>(reader.Byte());
+    last.x += static_cast<int>(reader.Signed());
+    last.y += static_cast<int>(reader.Signed());
+    mouse.position = last;
+    return mouse;
+}
+
+} // namespace
+
+InputRecorder::InputRecorder(const std::filesystem::path& path)
+    : _stream(path, std::ios::binary | std::ios::trunc)
+{
+    std::vector<std::uint8_t> header(MAGIC.begin(), MAGIC.end());
+    WriteVarint(header, VERSION);
+    _stream.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+}
+
+bool InputRecorder::IsOpen() const
+{
+    return _stream.is_open() && _stream.good();
+}
+
+void InputRecorder::RecordEvent(const sf::Event& event)
+{
+    if (const auto* resized = event.getIf<sf::Event::Resized>())
+    {
+        WriteByte(_events, static_cast<std::uint8_t>(RecordedEvent::Resized));
+        WriteVarint(_events, resized->size.x);
+        WriteVarint(_events, resized->size.y);
+    }
+    else if (event.is<sf::Event::FocusLost>())
+    {
+        WriteByte(_events, static_cast<std::uint8_t>(RecordedEvent::FocusLost));
+    }
+    else if (event.is<sf::Event::FocusGained>())
+    {
+        WriteByte(_events, static_cast<std::uint8_t>(RecordedEvent::FocusGained));
+    }
+    else if (const auto* keyPressed = event.getIf<sf::Event::KeyPressed>())
+    {
+        WriteKey(_events, RecordedEvent::KeyPressed, *keyPressed);
+    }
+    else if (const auto* keyReleased = event.getIf<sf::Event::KeyReleased>())
+    {
+        WriteKey(_events, RecordedEvent::KeyReleased, *keyReleased);
+    }
+    else if (const auto* mousePressed = event.getIf<sf::Event::MouseButtonPressed>())
+    {
+        WriteMouseButton(_events, RecordedEvent::MouseButtonPressed, *mousePressed, _mousePosition);
+    }
+    else if (const auto* mouseReleased = event.getIf<sf::Event::MouseButtonReleased>())
+    {
+        WriteMouseButton(_events, RecordedEvent::MouseButtonReleased, *mouseReleased, _mousePosition);
+    }
+    else
+    {
+        return;
+    }
+
+    ++_eventCount;
+}
+
+void InputRecorder::EndFrame(const InputSnapshot& snapshot, const float deltaTime)
+{
+    ZoneScopedN("InputRecorder::EndFrame");
+
+    _frame.clear();
+    WriteFloat(_frame, deltaTime);
+    WriteVarint(_frame, _eventCount);
+    _frame.insert(_frame.end(), _events.begin(), _events.end());
+
+    // Controls that flipped, each as the distance from the previous one
+    const InputSnapshot::Bits changed = snapshot.GetLive() ^ _live;
+    WriteVarint(_frame, changed.count());
+    std::size_t previous = 0;
+    for (std::size_t control = 0; control < InputSnapshot::CONTROLS; ++control)
+    {
+        if (changed[control])
+        {
+            WriteVarint(_frame, control - previous);
+            previous = control;
+        }
+    }
+    _live = snapshot.GetLive();
+
+    // Axes that moved, the same way
+    const InputSnapshot::Axes& axes = snapshot.GetAxes();
+    std::size_t moved = 0;
+    for (std::size_t axis = 0; axis < axes.size(); ++axis)
+    {
+        moved += axes[axis] != _axes[axis] ? 1 : 0;
+    }
+    WriteVarint(_frame, moved);
+    previous = 0;
+    for (std::size_t axis = 0; axis < axes.size(); ++axis)
+    {
+        if (axes[axis] != _axes[axis])
+        {
+            WriteVarint(_frame, axis - previous);
+            WriteFloat(_frame, axes[axis]);
+            previous = axis;
+        }
+    }
+    _axes = axes;
+
+    _stream.write(reinterpret_cast<const char*>(_frame.data()), static_cast<std::streamsize>(_frame.size()));
+    _events.clear();
+    _eventCount = 0;
+    ++_frameCount;
+}
+
+InputReplay::InputReplay(const std::filesystem::path& path)
+    : _stream(path, std::ios::binary)
+{
+    Reader reader{_stream};
+    std::array<char, 4> magic{};
+    for (char& c : magic)
+    {
+        c = static_cast<char>(reader.Byte());
+    }
+    const std::uint64_t version = reader.Varint();
+
+    _valid = reader.ok && magic == MAGIC && version == VERSION;
+}
+
+bool InputReplay::IsOpen() const
+{
+    return _valid;
+}
+
+bool InputReplay::NextFrame()
+{
+    ZoneScopedN("InputReplay::NextFrame");
+
+    if (!_valid || _stream.peek() == std::istream::traits_type::eof())
+    {
+        return false;
+    }
+
+    Reader reader{_stream};
+    _events.clear();
+
+    _deltaTime = reader.Float();
+    if (!(_deltaTime >= 0.f))
+    {
+        // Negative or NaN, the stream is corrupted
+        reader.ok = false;
+    }
+
+    const std::uint64_t eventCount = reader.Varint();
+    for (std::uint64_t i = 0; i < eventCount && reader.ok; ++i)
+    {
+        switch (static_cast<RecordedEvent>(reader.Byte()))
+        {
+            case RecordedEvent::Resized:
+            {
+                const auto width = static_cast<unsigned>(reader.Varint());
+                const auto height = static_cast<unsigned>(reader.Varint());
+                _events.emplace_back(sf::Event::Resized{{width, height}});
+                break;
+            }
+            case RecordedEvent::FocusLost: _events.emplace_back(sf::Event::FocusLost{}); break;
+            case RecordedEvent::FocusGained: _events.emplace_back(sf::Event::FocusGained{}); break;
+            case RecordedEvent::KeyPressed: _events.emplace_back(ReadKey<sf::Event::KeyPressed>(reader)); break;
+            case RecordedEvent::KeyReleased: _events.emplace_back(ReadKey<sf::Event::KeyReleased>(reader)); break;
+            case RecordedEvent::MouseButtonPressed:
+                _events.emplace_back(ReadMouseButton<sf::Event::MouseButtonPressed>(reader, _mousePosition));
+                break;
+            case RecordedEvent::MouseButtonReleased:
+                _events.emplace_back(ReadMouseButton<sf::Event::MouseButtonReleased>(reader, _mousePosition));
+                break;
+            default: reader.ok = false; break;
+        }
+    }
+
+    const std::uint64_t changed = reader.Varint();
+    std::uint64_t control = 0;
+    for (std::uint64_t i = 0; i < changed && reader.ok; ++i)
+    {
+        control += reader.Varint();
+        if (control >= InputSnapshot::CONTROLS)
+        {
+            reader.ok = false;
+            break;
+        }
+        _live.flip(control);
+    }
+
+    const std::uint64_t moved = reader.Varint();
+    std::uint64_t axis = 0;
+    for (std::uint64_t i = 0; i < moved && reader.ok; ++i)
+    {
+        axis += reader.Varint();
+        const float position = reader.Float();
+        if (axis >= _axes.size())
+        {
+            reader.ok = false;
+            break;
+        }
+        _axes[axis] = position;
+    }
+
+    // A truncated frame ends the replay, the state it left is not trusted anymore
+    _valid = reader.ok;
+    if (_valid)
+    {
+        ++_frameCount;
+    }
+    return _valid;
+}
+
+void InputReplay::ApplyTo(InputSnapshot& snapshot) const
+{
+    snapshot.Override(_live, _axes);
+}
@@ -0,0 +1,174 @@
+// Copyright (c) Eric Jeker 2025.
+
+#include "SFE/Modules/Input/Singletons/InputSnapshot.h"
+
+#include <cmath>
+#include <tracy/Tracy.hpp>
+
+namespace
+{
+
+constexpr auto NO_CONTROL = static_cast<std::size_t>(InputSnapshot::INVALID_CONTROL);
+
+std::size_t KeyControl(const sf::Keyboard::Key key)
+{
+    // Unknown is -1 and wraps past the end of the keys
+    const auto index = static_cast<std::size_t>(key);
+    return index < InputSnapshot::KEYS ? index : NO_CONTROL;
+}
+
+std::size_t MouseControl(const sf::Mouse::Button button)
+{
+    const auto index = static_cast<std::size_t>(button);
+    return index < InputSnapshot::MOUSE_BUTTONS ? InputSnapshot::MOUSE_OFFSET + index : NO_CONTROL;
+}
+
+} // namespace
+
+void InputSnapshot::Apply(const sf::Event& event)
+{
+    std::size_t pressed = NO_CONTROL;
+    std::size_t released = NO_CONTROL;
+
+    if (const auto* keyPressed = event.getIf<sf::Event::KeyPressed>())
+    {
+        pressed = KeyControl(keyPressed->code);
+    }
+    else if (const auto* keyReleased = event.getIf<sf::Event::KeyReleased>())
+    {
+        released = KeyControl(keyReleased->code);
+    }
+    else if (const auto* mousePressed = event.getIf<sf::Event::MouseButtonPressed>())
+    {
+        pressed = MouseControl(mousePressed->button);
+    }
+    else if (const auto* mouseReleased = event.getIf<sf::Event::MouseButtonReleased>())
+    {
+        released = MouseControl(mouseReleased->button);
+    }
+    else if (event.is<sf::Event::FocusLost>())
+    {
+        // The releases happening out of focus never come, the joysticks are sampled again on the next update
+        _live.reset();
+    }
+
+    if (pressed != NO_CONTROL)
+    {
+        _live.set(pressed);
+        _tapped.set(pressed);
+    }
+    if (released != NO_CONTROL)
+    {
+        _live.reset(released);
+    }
+}
+
+void InputSnapshot::Update()
+{
+    ZoneScopedN("InputSnapshot::Update");
+
+    if (!_overridden)
+    {
+        SampleJoysticks();
+    }
+
+    _previous = _held;
+    _held = _live | _tapped;
+    _tapped.reset();
+}
+
+void InputSnapshot::Override(const Bits& live, const Axes& axes)
+{
+    _live = live;
+    _axes = axes;
+    _overridden = true;
+}
+
+InputSnapshot::Control InputSnapshot::Compile(const InputKey& key)
+{
+    std::size_t control = NO_CONTROL;
+
+    if (const auto* keyboard = std::get_if<InputKey::Key>(&key.id))
+    {
+        control = KeyControl(keyboard->code);
+    }
+    else if (const auto* mouse = std::get_if<InputKey::MouseBtn>(&key.id))
+    {
+        control = MouseControl(mouse->button);
+    }
+    else if (const auto* button = std::get_if<InputKey::JoyButton>(&key.id))
+    {
+        if (button->id < JOYSTICKS && button->button < JOYSTICK_BUTTONS)
+        {
+            control = JOYSTICK_OFFSET + button->id * JOYSTICK_BUTTONS + button->button;
+        }
+    }
+    else if (const auto* axis = std::get_if<InputKey::JoyAxisDir>(&key.id))
+    {
+        if (axis->id < JOYSTICKS)
+        {
+            const AxisControl axisControl = {axis->id, axis->axis, axis->direction, axis->deadZone};
+            std::size_t index = 0;
+            while (index < _axisControls.size() &&
+                   !(_axisControls[index].joystick == axisControl.joystick &&
+                     _axisControls[index].axis == axisControl.axis &&
+                     _axisControls[index].direction == axisControl.direction &&
+                     _axisControls[index].deadZone == axisControl.deadZone))
+            {
+                ++index;
+            }
+
+            if (index == _axisControls.size() && index < MAX_AXIS_CONTROLS)
+            {
+                _axisControls.push_back(axisControl);
+            }
+            if (index < _axisControls.size())
+            {
+                control = AXIS_OFFSET + index;
+            }
+        }
+    }
+
+    return static_cast<Control>(control);
+}
+
+void InputSnapshot::ClearAxisControls()
+{
+    for (std::size_t i = 0; i < MAX_AXIS_CONTROLS; ++i)
+    {
+        _live.reset(AXIS_OFFSET + i);
+    }
+    _axisControls.clear();
+}
+
+void InputSnapshot::SampleJoysticks()
+{
+    // SFML keeps the joystick states cached, they are refreshed while polling the window events
+    for (unsigned joystick = 0; joystick < JOYSTICKS; ++joystick)
+    {
+        const bool connected = sf::Joystick::isConnected(joystick);
+        for (unsigned button = 0; button < JOYSTICK_BUTTONS; ++button)
+        {
+            _live.set(
+                JOYSTICK_OFFSET + joystick * JOYSTICK_BUTTONS + button,
+                connected && sf::Joystick::isButtonPressed(joystick, button)
+            );
+        }
+        for (unsigned axis = 0; axis < JOYSTICK_AXES; ++axis)
+        {
+            _axes[joystick * JOYSTICK_AXES + axis] =
+                connected ? sf::Joystick::getAxisPosition(joystick, static_cast<sf::Joystick::Axis>(axis)) : 0.f;
+        }
+    }
+
+    // Same test as InputKey::Joystick, on the sampled positions
+    for (std::size_t i = 0; i < _axisControls.size(); ++i)
+    {
+        const AxisControl& control = _axisControls[i];
+        const float position = GetAxis(control.joystick, control.axis);
+        const bool active = std::abs(position) >= control.deadZone &&
+                            ((control.direction > 0 && position >= static_cast<float>(control.direction)) ||
+                             (control.direction < 0 && position <= static_cast<float>(control.direction)));
+        _live.set(AXIS_OFFSET + i, active);
+    }
+}
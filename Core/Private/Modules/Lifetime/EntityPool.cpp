@@ -0,0 +1,114 @@
+// Copyright (c) Eric Jeker 2025.
+
+#include "SFE/Modules/Lifetime/Singletons/EntityPool.h"
+
+#include "SFE/Modules/Lifetime/Components/Pooled.h"
+
+#include <cassert>
+#include <cstring>
+
+namespace
+{
+
+/**
+ * Toggles the components of the entity that can be. The ids are collected first, the first toggle of a component
+ * adds its toggle bits to the entity and changes the type being walked.
+ */
+void ToggleComponents(const flecs::entity entity, const bool enabled, std::vector<flecs::id_t>& ids)
+{
+    const auto world = entity.world();
+
+    ids.clear();
+    entity.each([&](const flecs::id id) {
+        // Pairs and the toggle bits themselves carry flags
+        if (!id.has_flags() && flecs::entity(world, id).has(flecs::CanToggle))
+        {
+            ids.push_back(id);
+        }
+    });
+
+    for (const flecs::id_t id : ids)
+    {
+        entity.enable(id, enabled);
+    }
+}
+
+} // namespace
+
+flecs::entity EntityPool::Acquire(const flecs::world& world, const flecs::entity_t prefab)
+{
+    auto& free = _free[prefab];
+    while (!free.empty())
+    {
+        const flecs::entity_t id = free.back();
+        free.pop_back();
+
+        // Someone may have destroyed the entity while it was in the pool
+        if (!world.is_alive(id))
+        {
+            continue;
+        }
+
+        ++_reused;
+        const flecs::entity entity(world, id);
+        ToggleComponents(entity, true, _toggled);
+        return entity;
+    }
+
+    ++_created;
+    return world.entity().is_a(prefab).set<Pooled>({prefab});
+}
+
+void EntityPool::Release(const flecs::entity entity)
+{
+    assert(entity.has<Pooled>() && "Only the entities acquired from the pool can be released.");
+
+    const auto world = entity.world();
+    const flecs::entity_t prefabId = entity.get<Pooled>().prefab;
+    const flecs::entity prefab(world, prefabId);
+
+    // Only the components overridden from the prefab hold values of their own, the others are the prefab's. They are
+    // copied in place, a set would call the OnSet observers of an entity that is going away
+    prefab.each([&](const flecs::id id) {
+        if (id.is_pair() || !entity.owns(id))
+        {
+            return;
+        }
+
+        const ecs_type_info_t* info = ecs_get_type_info(world, id);
+        if (info == nullptr || info->size == 0)
+        {
+            return;
+        }
+
+        void* value = ecs_get_mut_id(world, entity, id);
+        const void* prefabValue = ecs_get_id(world, prefab, id);
+        if (info->hooks.copy != nullptr)
+        {
+            info->hooks.copy(value, prefabValue, 1, info);
+        }
+        else
+        {
+            std::memcpy(value, prefabValue, static_cast<std::size_t>(info->size));
+        }
+    });
+
+    ToggleComponents(entity, false, _toggled);
+    _free[prefabId].push_back(entity);
+}
+
+std::size_t EntityPool::GetFreeCount(const flecs::entity_t prefab) const
+{
+    const auto it = _free.find(prefab);
+    return it != _free.end() ? it->second.size() : 0;
+}
+
+std::uint64_t EntityPool::GetCreatedCount() const
+{
+    return _created;
+}
+
+std::uint64_t EntityPool::GetReusedCount() const
+{
+    return _reused;
+}
@@ -4,30 +4,63 @@
 
 #include "SFE/Modules/Lifetime/Components/Lifetime.h"
 #include "SFE/Modules/Lifetime/Components/LifetimeOneFrame.h"
+#include "SFE/Modules/Lifetime/Components/Pooled.h"
+#include "SFE/Modules/Lifetime/Singletons/EntityPool.h"
+#include "SFE/Modules/Lifetime/Singletons/LifetimeWheel.h"
+
+#include <tracy/Tracy.hpp>
 
 namespace
 {
 
-void UpdateLifetime(const flecs::iter& it, size_t, Lifetime& lifetime)
+void ScheduleLifetime(const flecs::iter& it, size_t idx, Lifetime& lifetime)
 {
-    lifetime.seconds -= it.delta_time();
+    auto& wheel = it.world().get_mut<LifetimeWheel>();
+    lifetime.expiryTick = wheel.Schedule(it.entity(idx), lifetime.seconds);
 }
 
-void LifetimeCull(const flecs::entity& e, const Lifetime& lifetime)
+/**
+ * Pops the entities due this frame from the wheel and destroys them in one deferred batch.
+ */
+void ExpireLifetimes(const flecs::iter& it)
 {
-    if (lifetime.seconds <= 0.f)
+    ZoneScopedN("LifetimeModule::ExpireLifetimes");
+
+    const auto world = it.world();
+    auto& wheel = world.get_mut<LifetimeWheel>();
+
+    for (const flecs::entity_t id : wheel.Advance(it.delta_time()))
     {
+        // Skips the entities destroyed since, or rescheduled by setting their Lifetime again
+        if (!world.is_alive(id))
+        {
+            continue;
+        }
+
+        const flecs::entity e(world, id);
+        const auto* lifetime = e.try_get<Lifetime>();
+        if (lifetime == nullptr || lifetime->expiryTick >= wheel.GetTick())
+        {
+            continue;
+        }
+
         e.destruct();
     }
 }
 
 /**
- * Destroys the given entity.
+ * Destroys the given entity, or gives it back to the pool it came from.
  *
  * @param e The flecs::entity object that needs to be destroyed.
  */
-void DestroyEntity(const flecs::entity& e, const LifetimeOneFrame&)
+void DestroyEntity(const flecs::entity& e, const LifetimeOneFrame&, EntityPool& pool)
 {
+    if (e.has<Pooled>())
+    {
+        pool.Release(e);
+        return;
+    }
+
     e.destruct();
 }
 
@@ -38,12 +71,24 @@ namespace Core::Modules
 
 LifetimeModule::LifetimeModule(const flecs::world& world)
 {
-    world.component<LifetimeOneFrame>();
+    // Toggled off on the released pooled entities, so the system doesn't release them again every frame
+    world.component<LifetimeOneFrame>().add(flecs::CanToggle);
     world.component<Lifetime>();
 
-    world.system<Lifetime>("LifetimeUpdateSystem").kind(flecs::OnUpdate).each(UpdateLifetime);
-    world.system<const Lifetime>("LifetimeCullSystem").kind(flecs::PostUpdate).each(LifetimeCull);
-    world.system<const LifetimeOneFrame>("LifetimeOneFrameSystem").kind(flecs::PostUpdate).each(DestroyEntity);
+    world.component<LifetimeWheel>();
+    world.component<Pooled>();
+    world.component<EntityPool>();
+
+    world.set<LifetimeWheel>({});
+    world.set<EntityPool>({});
+
+    world.observer<Lifetime>("ScheduleLifetime").event(flecs::OnSet).each(ScheduleLifetime);
+    world.system("LifetimeExpirySystem").kind(flecs::PostUpdate).run(ExpireLifetimes);
+    world.system<const LifetimeOneFrame, EntityPool>("LifetimeOneFrameSystem")
+        .term_at(1)
+        .singleton()
+        .kind(flecs::PostUpdate)
+        .each(DestroyEntity);
 }
 
 } // namespace Modules
@@ -0,0 +1,113 @@
+// Copyright (c) Eric Jeker 2025.
+
+#include "SFE/Modules/Lifetime/Singletons/LifetimeWheel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+constexpr std::uint64_t SLOT_MASK = LifetimeWheel::SLOTS - 1;
+// Past what the top level covers the entry waits in its last slot and is placed again when it comes up
+constexpr std::uint64_t MAX_DELAY = (std::uint64_t{1} << (LifetimeWheel::SLOT_BITS * LifetimeWheel::LEVELS)) - 1;
+
+} // namespace
+
+std::uint64_t LifetimeWheel::Schedule(const flecs::entity_t entity, const float seconds)
+{
+    const double expiry = std::ceil((_time + std::max(seconds, 0.f)) * static_cast<double>(TICKS_PER_SECOND));
+    const auto expiryTick = std::max(static_cast<std::uint64_t>(expiry), _tick);
+
+    Insert({entity, expiryTick});
+    ++_size;
+    return expiryTick;
+}
+
+std::span<const flecs::entity_t> LifetimeWheel::Advance(const float deltaTime)
+{
+    _expired.clear();
+    _time += deltaTime;
+    const auto lastTick = static_cast<std::uint64_t>(_time * static_cast<double>(TICKS_PER_SECOND));
+
+    for (; _tick <= lastTick; ++_tick)
+    {
+        // The upper levels are spread first so their entries can go down several levels on the same tick
+        std::size_t level = 1;
+        while (level < LEVELS && (_tick & ((std::uint64_t{1} << (SLOT_BITS * level)) - 1)) == 0)
+        {
+            ++level;
+        }
+        for (std::size_t l = level - 1; l >= 1; --l)
+        {
+            Cascade(l);
+        }
+
+        auto& slot = _slots[0][_tick & SLOT_MASK];
+        for (const Entry& entry : slot)
+        {
+            _expired.push_back(entry.entity);
+        }
+        _size -= slot.size();
+        slot.clear();
+    }
+    return _expired;
+}
+
+double LifetimeWheel::GetTime() const
+{
+    return _time;
+}
+
+std::uint64_t LifetimeWheel::GetTick() const
+{
+    return _tick;
+}
+
+float LifetimeWheel::GetRemaining(const std::uint64_t expiryTick) const
+{
+    return static_cast<float>(static_cast<double>(expiryTick) / static_cast<double>(TICKS_PER_SECOND) - _time);
+}
+
+std::size_t LifetimeWheel::Size() const
+{
+    return _size;
+}
+
+void LifetimeWheel::Insert(const Entry& entry)
+{
+    const std::uint64_t delay = std::min(entry.expiryTick - _tick, MAX_DELAY);
+    const std::uint64_t slotTick = _tick + delay;
+
+    std::size_t level = 0;
+    while (level + 1 < LEVELS && delay >= (std::uint64_t{1} << (SLOT_BITS * (level + 1))))
+    {
+        ++level;
+    }
+
+    _slots[level][(slotTick >> (SLOT_BITS * level)) & SLOT_MASK].push_back(entry);
+}
+
+void LifetimeWheel::Cascade(const std::size_t level)
+{
+    auto& slot = _slots[level][(_tick >> (SLOT_BITS * level)) & SLOT_MASK];
+    if (slot.empty())
+    {
+        return;
+    }
+
+    // Swapped out first, an entry may land in the same slot again when it is beyond what the top level covers
+    std::vector<Entry> entries;
+    entries.swap(slot);
+    for (const Entry& entry : entries)
+    {
+        Insert(entry);
+    }
+
+    // Keeps the capacity of the slot so it doesn't allocate the next time it fills
+    entries.clear();
+    if (slot.empty())
+    {
+        slot.swap(entries);
+    }
+}
@@ -0,0 +1,31 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include "SFE/Modules/Lifetime/Components/Lifetime.h"
+#include "SFE/Modules/Particles/Components/Particle.h"
+#include "SFE/Modules/Physics/Components/Velocity.h"
+#include "SFE/Modules/Render/Components/Transform.h"
+#include "SFE/Modules/Render/Components/ZOrder.h"
+
+#include <SFML/Graphics/Color.hpp>
+
+#include <vector>
+
+/**
+ * @brief Scratch arrays of the entity particle spawns, a singleton of each world kept between frames so spawning
+ * doesn't allocate.
+ */
+struct EntitySpawnScratch
+{
+    std::vector<sf::Vector2f> positions;
+    std::vector<sf::Vector2f> velocities;
+    std::vector<float> lifetimes;
+    std::vector<sf::Color> colors;
+
+    std::vector<Transform> transforms;
+    std::vector<Velocity> velocityComponents;
+    std::vector<Lifetime> lifetimeComponents;
+    std::vector<ZOrder> zOrders;
+    std::vector<Particle> particleComponents;
+};
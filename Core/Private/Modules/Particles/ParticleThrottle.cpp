@@ -0,0 +1,36 @@
+// Copyright (c) Eric Jeker 2025.
+
+#include "SFE/Modules/Particles/ParticleThrottle.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace ParticleThrottle
+{
+
+float Update(const float throttle, const std::chrono::nanoseconds measured, const std::chrono::nanoseconds budget,
+             const float deltaTime, const float recoveryPerSecond)
+{
+    assert(budget.count() > 0 && "The particle frame budget must be greater than 0.");
+
+    if (measured > budget)
+    {
+        const float ratio = static_cast<float>(budget.count()) / static_cast<float>(measured.count());
+        return std::clamp(throttle * ratio, 0.f, 1.f);
+    }
+
+    return std::min(1.f, throttle + recoveryPerSecond * deltaTime);
+}
+
+float RateScale(const float throttle, const int priority)
+{
+    if (throttle >= 1.f)
+    {
+        return 1.f;
+    }
+
+    return std::pow(std::max(throttle, 0.f), 1.f / static_cast<float>(1 + std::max(priority, 0)));
+}
+
+} // namespace ParticleThrottle
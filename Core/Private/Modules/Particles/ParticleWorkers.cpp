@@ -0,0 +1,90 @@
+// Copyright (c) Eric Jeker 2025.
+
+#include "Modules/Particles/ParticleWorkers.h"
+
+#include <algorithm>
+
+ParticleWorkers::ParticleWorkers(const unsigned threadCount)
+{
+    _threads.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i)
+    {
+        _threads.emplace_back([this](const std::stop_token& stop) { WorkerLoop(stop); });
+    }
+}
+
+ParticleWorkers::~ParticleWorkers()
+{
+    // Joined before the members they wait on are destroyed
+    _threads.clear();
+}
+
+void ParticleWorkers::Dispatch(const std::size_t count, const std::size_t grain, const Invoke invoke, void* ctx)
+{
+    if (_threads.empty() || count <= grain)
+    {
+        invoke(ctx, 0, count);
+        return;
+    }
+
+    {
+        std::lock_guard lock(_mutex);
+        _invoke = invoke;
+        _ctx = ctx;
+        _count = count;
+        _grain = grain;
+        _next.store(0, std::memory_order_relaxed);
+        _busy = _threads.size();
+        ++_generation;
+    }
+    _wake.notify_all();
+
+    RunChunks();
+
+    std::unique_lock lock(_mutex);
+    _done.wait(lock, [this] { return _busy == 0; });
+    _invoke = nullptr;
+    _ctx = nullptr;
+}
+
+std::size_t ParticleWorkers::GetThreadCount() const
+{
+    return _threads.size() + 1;
+}
+
+void ParticleWorkers::WorkerLoop(const std::stop_token& stop)
+{
+    std::uint64_t seen = 0;
+    while (true)
+    {
+        {
+            std::unique_lock lock(_mutex);
+            if (!_wake.wait(lock, stop, [&] { return _generation != seen; }))
+            {
+                return;
+            }
+            seen = _generation;
+        }
+
+        RunChunks();
+
+        std::lock_guard lock(_mutex);
+        if (--_busy == 0)
+        {
+            _done.notify_one();
+        }
+    }
+}
+
+void ParticleWorkers::RunChunks()
+{
+    while (true)
+    {
+        const std::size_t begin = _next.fetch_add(_grain, std::memory_order_relaxed);
+        if (begin >= _count)
+        {
+            return;
+        }
+        _invoke(_ctx, begin, std::min(begin + _grain, _count));
+    }
+}
@@ -0,0 +1,63 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Small pool of persistent threads splitting a range of particles in chunks.
+ *
+ * The calling thread takes chunks as well and ParallelFor only returns once every chunk is done, so the job can
+ * freely reference the caller's stack and is passed by pointer, nothing is allocated per call. Chunks are handed out
+ * through an atomic counter, a slow thread simply takes fewer of them.
+ */
+class ParticleWorkers
+{
+public:
+    explicit ParticleWorkers(unsigned threadCount);
+    ~ParticleWorkers();
+
+    ParticleWorkers(const ParticleWorkers&) = delete;
+    ParticleWorkers& operator=(const ParticleWorkers&) = delete;
+
+    /**
+     * @brief Calls job(begin, end) on chunks of at most grain items covering [0, count).
+     */
+    template <typename Job>
+    void ParallelFor(const std::size_t count, const std::size_t grain, Job& job)
+    {
+        Dispatch(count, grain, [](void* ctx, const std::size_t begin, const std::size_t end) {
+            (*static_cast<Job*>(ctx))(begin, end);
+        }, &job);
+    }
+
+    /** @brief Threads taking part in a ParallelFor, the caller included. */
+    [[nodiscard]] std::size_t GetThreadCount() const;
+
+private:
+    using Invoke = void (*)(void* ctx, std::size_t begin, std::size_t end);
+
+    void Dispatch(std::size_t count, std::size_t grain, Invoke invoke, void* ctx);
+    void WorkerLoop(const std::stop_token& stop);
+    void RunChunks();
+
+    std::mutex _mutex;
+    std::condition_variable_any _wake;
+    std::condition_variable _done;
+    std::uint64_t _generation = 0;
+    std::size_t _busy = 0;
+
+    Invoke _invoke = nullptr;
+    void* _ctx = nullptr;
+    std::size_t _count = 0;
+    std::size_t _grain = 1;
+    std::atomic<std::size_t> _next{0};
+
+    std::vector<std::jthread> _threads;
+};
@@ -2,44 +2,235 @@
 
 #include "SFE/Modules/Particles/ParticlesModule.h"
 
+#include "Modules/Particles/EntitySpawnScratch.h"
+#include "Modules/Particles/ParticleWorkers.h"
+
 #include "SFE/Modules/Lifetime/Components/Lifetime.h"
+#include "SFE/Modules/Lifetime/Singletons/LifetimeWheel.h"
 #include "SFE/Modules/Particles/Components/Particle.h"
 #include "SFE/Modules/Particles/Components/ParticleEmitter.h"
+#include "SFE/Modules/Particles/ParticleThrottle.h"
 #include "SFE/Modules/Particles/Prefabs/Particle.h"
+#include "SFE/Modules/Particles/Singletons/ParticleBudget.h"
+#include "SFE/Modules/Particles/Singletons/ParticleForces.h"
 #include "SFE/Modules/Physics/Components/Velocity.h"
 #include "SFE/Modules/Render/Components/Transform.h"
 #include "SFE/Modules/Render/Components/ZOrder.h"
 #include "SFE/Utils/Random.h"
 
+#include <tracy/Tracy.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <numbers>
+#include <span>
+#include <thread>
+#include <vector>
+
 namespace
 {
 
-ParticleGenerator CreateDefaultParticleGenerator()
+constexpr float PARTICLE_Z_ORDER = 1000.f;
+
+// Particles simulated per chunk, a chunk of positions, velocities and ages fits in the L1 cache
+constexpr std::size_t PARTICLE_CHUNK = 2048;
+// Smaller emitters are simulated on the calling thread, waking the workers would cost more than it saves
+constexpr std::size_t PARALLEL_THRESHOLD = 16384;
+// Keeps the attractors and vortices from blowing particles away when they pass right through the center
+constexpr float FORCE_SOFTENING = 1.f;
+
+/**
+ * Spawns the particles on the emitter, flying in a random direction within the angle range of the emitter.
+ */
+void GenerateDefaultParticles(const ParticleEmitter& emitter, const Transform& emitterTransform, const ParticleSpawnBatch& batch)
+{
+    constexpr float degreesToRadians = std::numbers::pi_v<float> / 180.f;
+
+    for (std::size_t i = 0; i < batch.Size(); i++)
+    {
+        const float angle = (emitterTransform.rotation + Random::UniformFloat(emitter.minAngleDeg, emitter.maxAngleDeg))
+            * degreesToRadians;
+        const float speed = Random::UniformFloat(emitter.minVelocity, emitter.maxVelocity);
+        batch.positions[i] = emitterTransform.position;
+        batch.velocities[i] = sf::Vector2f{std::cos(angle), std::sin(angle)} * speed;
+        batch.lifetimes[i] = Random::UniformFloat(emitter.minLifetime, emitter.maxLifetime);
+        batch.colors[i] = emitter.color;
+    }
+}
+
+/**
+ * Samples the keys at the given normalised time, clamped to the first and last key.
+ */
+template <typename T, typename Lerp>
+T SampleCurve(const std::vector<ParticleCurveKey<T>>& keys, const float time, Lerp&& lerp)
+{
+    if (time <= keys.front().time)
+    {
+        return keys.front().value;
+    }
+
+    for (std::size_t i = 1; i < keys.size(); i++)
+    {
+        if (time <= keys[i].time)
+        {
+            const auto& from = keys[i - 1];
+            const auto& to = keys[i];
+            const float span = to.time - from.time;
+            return lerp(from.value, to.value, span > 0.f ? (time - from.time) / span : 1.f);
+        }
+    }
+
+    return keys.back().value;
+}
+
+template <typename T, typename U, typename Lerp>
+bool BakeCurve(const std::vector<ParticleCurveKey<T>>& keys, std::array<U, ParticleCurveTables::RESOLUTION>& table,
+               Lerp&& lerp)
 {
-    return [](flecs::world world, const ParticleEmitter& emitter, const Transform& emitterTransform) -> flecs::entity
+    if (keys.empty())
     {
-        const auto velocity = Random::UniformFloat(emitter.minVelocity, emitter.maxVelocity);
-        const sf::Vector2f v = {Random::UniformFloat(-velocity, velocity), Random::UniformFloat(-velocity, velocity)};
-        return world.entity()
-            .is_a<Prefabs::Particle>()
-            .set<Velocity>({v})
-            .set<ZOrder>({1000.f})
-            .set<Transform>({.position = emitterTransform.position})
-            .set<Lifetime>({Random::UniformFloat(emitter.minLifetime, emitter.maxLifetime)});
+        return false;
+    }
+
+    for (std::size_t i = 0; i < table.size(); i++)
+    {
+        const float time = static_cast<float>(i) / static_cast<float>(table.size() - 1);
+        table[i] = static_cast<U>(SampleCurve(keys, time, lerp));
+    }
+    return true;
+}
+
+/**
+ * Bakes the over-lifetime curves of the emitter, the particles then only fetch from the tables.
+ */
+void BakeParticleCurves(ParticleEmitter& emitter)
+{
+    ZoneScopedN("ParticlesModule::BakeParticleCurves");
+
+    const auto lerpFloat = [](const float a, const float b, const float t) { return a + (b - a) * t; };
+    const auto lerpChannel = [&](const std::uint8_t a, const std::uint8_t b, const float t) {
+        return static_cast<std::uint8_t>(std::lround(lerpFloat(a, b, t)));
+    };
+    const auto lerpColor = [&](const sf::Color& a, const sf::Color& b, const float t) {
+        return sf::Color{lerpChannel(a.r, b.r, t), lerpChannel(a.g, b.g, t), lerpChannel(a.b, b.b, t), lerpChannel(a.a, b.a, t)};
+    };
+    const auto lerpAlpha = [&](const float a, const float b, const float t) {
+        return std::lround(std::clamp(lerpFloat(a, b, t), 0.f, 1.f) * 255.f);
     };
+
+    auto& tables = emitter.curveTables;
+    tables.hasColor = BakeCurve(emitter.curves.color, tables.colors, lerpColor);
+    tables.hasAlpha = BakeCurve(emitter.curves.alpha, tables.alphas, lerpAlpha);
+    tables.hasSize = BakeCurve(emitter.curves.size, tables.sizes, lerpFloat);
 }
 
-void EmitParticles(const flecs::iter& it, size_t idx, ParticleEmitter& emitter, const Transform& transform)
+void GenerateBatch(const ParticleEmitter& emitter, const Transform& transform, const ParticleSpawnBatch& batch)
+{
+    if (emitter.batchGenerator)
+    {
+        emitter.batchGenerator(emitter, transform, batch);
+        return;
+    }
+
+    GenerateDefaultParticles(emitter, transform, batch);
+}
+
+void SpawnIntoBuffer(ParticleEmitter& emitter, const Transform& transform, const int count)
+{
+    auto& particles = emitter.particles;
+
+    // The generator writes straight into the tail of the arrays
+    particles.Reserve(static_cast<std::size_t>(emitter.maxParticles));
+    const std::size_t first = particles.Grow(static_cast<std::size_t>(count));
+    GenerateBatch(
+        emitter,
+        transform,
+        {
+            .positions = std::span(particles.positions).subspan(first),
+            .velocities = std::span(particles.velocities).subspan(first),
+            .lifetimes = std::span(particles.lifetimes).subspan(first),
+            .colors = std::span(particles.colors).subspan(first),
+        }
+    );
+}
+
+/**
+ * The whole batch is created with one ecs_bulk_init: the entities land in their final table with all their
+ * components, instead of moving through one table per set<>.
+ */
+void SpawnEntities(const flecs::world& world, const flecs::entity emitterEntity, const ParticleEmitter& emitter,
+                   const Transform& transform, const int count)
+{
+    ZoneScopedN("ParticlesModule::SpawnEntities");
+
+    auto& scratch = world.get_mut<EntitySpawnScratch>();
+    const auto size = static_cast<std::size_t>(count);
+
+    scratch.positions.resize(size);
+    scratch.velocities.resize(size);
+    scratch.lifetimes.resize(size);
+    scratch.colors.resize(size);
+    GenerateBatch(
+        emitter,
+        transform,
+        {.positions = scratch.positions, .velocities = scratch.velocities, .lifetimes = scratch.lifetimes, .colors = scratch.colors}
+    );
+
+    scratch.transforms.resize(size);
+    scratch.velocityComponents.resize(size);
+    scratch.lifetimeComponents.resize(size);
+    scratch.zOrders.resize(size);
+    scratch.particleComponents.resize(size);
+    for (std::size_t i = 0; i < size; i++)
+    {
+        scratch.transforms[i] = {.position = scratch.positions[i]};
+        scratch.velocityComponents[i] = {scratch.velocities[i]};
+        scratch.lifetimeComponents[i] = {scratch.lifetimes[i]};
+        scratch.zOrders[i] = {PARTICLE_Z_ORDER};
+        scratch.particleComponents[i] = {.color = scratch.colors[i], .lifetime = scratch.lifetimes[i]};
+    }
+
+    // The particles are parented to their emitter so they can find it back when they die
+    ecs_bulk_desc_t desc = {};
+    desc.count = count;
+    desc.ids[0] = world.id<Transform>();
+    desc.ids[1] = world.id<Velocity>();
+    desc.ids[2] = world.id<Lifetime>();
+    desc.ids[3] = world.id<ZOrder>();
+    desc.ids[4] = world.id<Particle>();
+    desc.ids[5] = world.pair(flecs::IsA, world.id<Prefabs::Particle>());
+    desc.ids[6] = world.pair(flecs::ChildOf, emitterEntity);
+
+    std::array<void*, 7> data = {
+        scratch.transforms.data(),
+        scratch.velocityComponents.data(),
+        scratch.lifetimeComponents.data(),
+        scratch.zOrders.data(),
+        scratch.particleComponents.data(),
+        nullptr,
+        nullptr,
+    };
+    desc.data = data.data();
+
+    ecs_bulk_init(world.get_world().c_ptr(), &desc);
+}
+
+void EmitParticles(const flecs::iter& it, size_t idx, ParticleEmitter& emitter, const Transform& transform,
+                   ParticleBudget& budget)
 {
     if (!emitter.enabled)
     {
         return;
     }
 
-    const float dt = it.world().delta_time();
+    const float dt = it.delta_time();
 
-    // Determine how many new particles to spawn
-    emitter.spawnAccumulator += emitter.ratePerSecond * dt;
+    // Determine how many new particles to spawn, the budget throttles the emitters when the particles run late
+    const float rateScale = ParticleThrottle::RateScale(budget.throttle, emitter.priority);
+    emitter.spawnAccumulator += emitter.ratePerSecond * rateScale * dt;
     const int toSpawn = static_cast<int>(emitter.spawnAccumulator);
     if (toSpawn <= 0)
     {
@@ -47,33 +238,228 @@ void EmitParticles(const flecs::iter& it, size_t idx, ParticleEmitter& emitter,
     }
     emitter.spawnAccumulator -= static_cast<float>(toSpawn);
 
-    // Enforce capacity
-    int countParticles = 0;
-    it.entity(idx).children(
-        [&](const flecs::entity e)
-        {
-            if (e.has<Particle>())
+    // Enforce capacity, the live counts are kept up to date by the spawns, the ForgetParticle observer and the buffer
+    const int globalRoom = budget.maxParticles - budget.liveParticles;
+    const int count = std::min({toSpawn, emitter.maxParticles - emitter.liveParticles, globalRoom});
+    if (globalRoom < toSpawn)
+    {
+        budget.capHits++;
+    }
+    if (count <= 0)
+    {
+        return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    // The entity particles expire through the LifetimeWheel, which also gives the curves the age of the particles
+    assert((emitter.storage == ParticleStorage::Buffer || it.world().has<LifetimeWheel>()) &&
+           "LifetimeWheel singleton does not exist, import the LifetimeModule.");
+
+    const flecs::entity emitterEntity = it.entity(idx);
+    if (emitter.storage == ParticleStorage::Buffer)
+    {
+        SpawnIntoBuffer(emitter, transform, count);
+    }
+    else if (emitter.generator)
+    {
+        // The per particle generator runs deferred so the commands of each particle are batched in one table move
+        it.world().defer([&] {
+            for (int i = 0; i < count; i++)
             {
-                countParticles++;
+                emitter.generator(it.world(), emitter, transform).child_of(emitterEntity);
             }
+        });
+    }
+    else
+    {
+        SpawnEntities(it.world(), emitterEntity, emitter, transform, count);
+    }
+    emitter.liveParticles += count;
+    budget.liveParticles += count;
+
+    budget.updateTime += std::chrono::steady_clock::now() - start;
+}
+
+void ForgetParticle(const flecs::entity e, const Particle&)
+{
+    const flecs::entity parent = e.parent();
+    if (!parent.is_valid())
+    {
+        return;
+    }
+
+    if (auto* emitter = parent.try_get_mut<ParticleEmitter>(); emitter != nullptr && emitter->liveParticles > 0)
+    {
+        emitter->liveParticles--;
+    }
+}
+
+ParticleWorkers& GetWorkers()
+{
+    static ParticleWorkers workers(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+    return workers;
+}
+
+/**
+ * Integrates a range of particles. Each force is its own branch-free sweep over the range so the compiler can
+ * vectorise the loops, and the range is small enough to stay in cache from one sweep to the next.
+ */
+void SimulateParticles(const ParticleForces& forces, const float dt, const std::span<sf::Vector2f> positions,
+                       const std::span<sf::Vector2f> velocities, const std::span<float> ages)
+{
+    const std::size_t count = positions.size();
+
+    const sf::Vector2f gravity = forces.gravity * dt;
+    const float damping = std::max(0.f, 1.f - forces.drag * dt);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        velocities[i] = (velocities[i] + gravity) * damping;
+    }
+
+    for (const auto& attractor : forces.attractors)
+    {
+        const float radiusSq = attractor.radius * attractor.radius;
+        const float impulse = attractor.strength * dt;
+        for (std::size_t i = 0; i < count; i++)
+        {
+            const sf::Vector2f d = attractor.position - positions[i];
+            const float distanceSq = d.x * d.x + d.y * d.y + FORCE_SOFTENING;
+            const float inside = distanceSq < radiusSq ? 1.f : 0.f;
+            velocities[i] += d * (inside * impulse / (distanceSq * std::sqrt(distanceSq)));
         }
-    );
+    }
 
-    if (countParticles > emitter.maxParticles)
+    for (const auto& vortex : forces.vortices)
+    {
+        const float radiusSq = vortex.radius * vortex.radius;
+        const float impulse = vortex.strength * dt;
+        for (std::size_t i = 0; i < count; i++)
+        {
+            const sf::Vector2f d = positions[i] - vortex.position;
+            const float distanceSq = d.x * d.x + d.y * d.y + FORCE_SOFTENING;
+            const float inside = distanceSq < radiusSq ? 1.f : 0.f;
+            velocities[i] += sf::Vector2f{-d.y, d.x} * (inside * impulse / distanceSq);
+        }
+    }
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        positions[i] += velocities[i] * dt;
+        ages[i] += dt;
+    }
+}
+
+/**
+ * Moves, ages, colors and culls the particles of the buffer, the whole emitter is processed without touching the ECS.
+ * Large emitters are split across the workers, the culling stays on this thread as it reorders the arrays.
+ */
+void UpdateParticleBuffer(const flecs::iter& it, size_t, ParticleEmitter& emitter, ParticleBudget& budget)
+{
+    ZoneScopedN("ParticlesModule::UpdateParticleBuffer");
+
+    auto& particles = emitter.particles;
+    if (particles.Size() == 0)
     {
         return;
     }
 
-    // Set default generator if none provided
-    if (!emitter.generator)
+    const auto start = std::chrono::steady_clock::now();
+
+    const float dt = it.delta_time();
+    const auto& forces = it.world().get<ParticleForces>();
+    const auto& tables = emitter.curveTables;
+
+    auto simulate = [&](const std::size_t begin, const std::size_t end) {
+        const std::size_t count = end - begin;
+        SimulateParticles(
+            forces,
+            dt,
+            std::span(particles.positions).subspan(begin, count),
+            std::span(particles.velocities).subspan(begin, count),
+            std::span(particles.ages).subspan(begin, count)
+        );
+
+        if (!tables.IsEmpty())
+        {
+            for (std::size_t i = begin; i < end; i++)
+            {
+                const std::size_t index = ParticleCurveTables::Index(particles.ages[i], particles.lifetimes[i]);
+                tables.Apply(index, particles.colors[i], particles.sizes[i]);
+            }
+        }
+    };
+
+    if (particles.Size() < PARALLEL_THRESHOLD)
+    {
+        simulate(0, particles.Size());
+    }
+    else
     {
-        emitter.generator = CreateDefaultParticleGenerator();
+        GetWorkers().ParallelFor(particles.Size(), PARTICLE_CHUNK, simulate);
     }
 
-    for (int i = 0; i < toSpawn; i++)
+    std::size_t i = 0;
+    while (i < particles.Size())
     {
-        emitter.generator(it.world(), emitter, transform);
+        if (particles.ages[i] >= particles.lifetimes[i])
+        {
+            // The last particle takes the slot, it is checked on the next iteration
+            particles.SwapRemove(i);
+            continue;
+        }
+        ++i;
     }
+
+    emitter.liveParticles = static_cast<int>(particles.Size());
+
+    budget.updateTime += std::chrono::steady_clock::now() - start;
+}
+
+/**
+ * Runs first each frame: the throttle follows the time the particles took last frame, and the live count is summed
+ * back from the emitters so the particles that died since are accounted for.
+ */
+void UpdateParticleBudget(const flecs::iter& it, size_t, ParticleBudget& budget)
+{
+    ZoneScopedN("ParticlesModule::UpdateParticleBudget");
+
+    budget.lastFrameTime = budget.updateTime + budget.renderTime;
+    if (budget.lastFrameTime > budget.frameBudget)
+    {
+        budget.budgetHits++;
+    }
+
+    budget.throttle = ParticleThrottle::Update(
+        budget.throttle,
+        budget.lastFrameTime,
+        budget.frameBudget,
+        it.delta_time(),
+        budget.recoveryPerSecond
+    );
+    budget.updateTime = {};
+    budget.renderTime = {};
+
+    int liveParticles = 0;
+    it.world().each([&](const ParticleEmitter& emitter) { liveParticles += emitter.liveParticles; });
+    budget.liveParticles = liveParticles;
+}
+
+/**
+ * The entity particles fetch their color and size from the curves of their parent emitter.
+ */
+void ApplyEmitterCurves(Particle& particle, const Lifetime& lifetime, const ParticleEmitter& emitter,
+                        const LifetimeWheel& wheel)
+{
+    const auto& tables = emitter.curveTables;
+    if (tables.IsEmpty())
+    {
+        return;
+    }
+
+    const float age = particle.lifetime - wheel.GetRemaining(lifetime.expiryTick);
+    const std::size_t index = ParticleCurveTables::Index(age, particle.lifetime);
+    tables.Apply(index, particle.color, particle.size);
 }
 
 } // namespace
@@ -85,10 +471,46 @@ ParticlesModule::ParticlesModule(const flecs::world& world)
 {
     world.component<ParticleEmitter>();
     world.component<Particle>();
+    world.component<ParticleForces>();
+    world.component<ParticleBudget>();
+    world.component<EntitySpawnScratch>();
+
+    world.set<ParticleForces>({});
+    world.set<ParticleBudget>({});
+    world.set<EntitySpawnScratch>({});
 
     world.prefab<Prefabs::Particle>().add<Velocity>().add<Transform>().add<Particle>().add<ZOrder>().add<Lifetime>();
 
-    world.system<ParticleEmitter, const Transform>("ParticleEmitterSystem").kind(flecs::OnUpdate).each(EmitParticles);
+    world.system<ParticleBudget>("ParticleBudgetSystem")
+        .term_at(0)
+        .singleton()
+        .kind(flecs::OnUpdate)
+        .each(UpdateParticleBudget);
+    // Immediate, the bulk creation of the particles can't be deferred
+    world.system<ParticleEmitter, const Transform, ParticleBudget>("ParticleEmitterSystem")
+        .term_at(2)
+        .singleton()
+        .immediate()
+        .kind(flecs::OnUpdate)
+        .each(EmitParticles);
+    world.observer<ParticleEmitter>("BakeParticleCurves").event(flecs::OnSet).each(BakeParticleCurves);
+    world.observer<const Particle>("ForgetParticle").event(flecs::OnRemove).each(ForgetParticle);
+    world.system<ParticleEmitter, ParticleBudget>("ParticleBufferSystem")
+        .term_at(1)
+        .singleton()
+        .kind(flecs::OnUpdate)
+        .each(UpdateParticleBuffer);
+    // Only the particles owning their Particle component, the ones of a custom generator may share the prefab's
+    // The age of the particles comes from the LifetimeWheel, the LifetimeModule must be imported for the curves
+    world.system<Particle, const Lifetime, const ParticleEmitter, const LifetimeWheel>("ParticleCurveSystem")
+        .term_at(0)
+        .self()
+        .term_at(2)
+        .up(flecs::ChildOf)
+        .term_at(3)
+        .singleton()
+        .kind(flecs::OnUpdate)
+        .each(ApplyEmitterCurves);
 }
 
 } // namespace Modules
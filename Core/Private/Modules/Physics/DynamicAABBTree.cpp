@@ -0,0 +1,335 @@
+// Copyright (c) Eric Jeker 2025.
+
+#include "SFE/Modules/Physics/DynamicAABBTree.h"
+
+#include <cmath>
+
+std::int32_t DynamicAABBTree::CreateProxy(const sf::FloatRect& aabb, const std::uint64_t userData)
+{
+    const std::int32_t proxy = AllocateNode();
+
+    Node& node = _nodes[proxy];
+    const Bounds bounds = ToBounds(aabb);
+    node.aabb = {bounds.min - sf::Vector2f(AABB_MARGIN, AABB_MARGIN), bounds.max + sf::Vector2f(AABB_MARGIN, AABB_MARGIN)};
+    node.userData = userData;
+    node.height = 0;
+
+    InsertLeaf(proxy);
+    ++_proxyCount;
+
+    return proxy;
+}
+
+void DynamicAABBTree::DestroyProxy(const std::int32_t proxy)
+{
+    assert(proxy >= 0 && proxy < static_cast<std::int32_t>(_nodes.size()) && _nodes[proxy].IsLeaf());
+
+    RemoveLeaf(proxy);
+    FreeNode(proxy);
+    --_proxyCount;
+}
+
+bool DynamicAABBTree::MoveProxy(const std::int32_t proxy, const sf::FloatRect& aabb, const sf::Vector2f& displacement)
+{
+    assert(proxy >= 0 && proxy < static_cast<std::int32_t>(_nodes.size()) && _nodes[proxy].IsLeaf());
+
+    const Bounds bounds = ToBounds(aabb);
+    if (Contains(_nodes[proxy].aabb, bounds))
+    {
+        return false;
+    }
+
+    RemoveLeaf(proxy);
+
+    Bounds fat = {bounds.min - sf::Vector2f(AABB_MARGIN, AABB_MARGIN), bounds.max + sf::Vector2f(AABB_MARGIN, AABB_MARGIN)};
+    const sf::Vector2f prediction = displacement * DISPLACEMENT_MULTIPLIER;
+    (prediction.x < 0.f ? fat.min.x : fat.max.x) += prediction.x;
+    (prediction.y < 0.f ? fat.min.y : fat.max.y) += prediction.y;
+    _nodes[proxy].aabb = fat;
+
+    InsertLeaf(proxy);
+    return true;
+}
+
+std::uint64_t DynamicAABBTree::GetUserData(const std::int32_t proxy) const
+{
+    return _nodes[proxy].userData;
+}
+
+sf::FloatRect DynamicAABBTree::GetFatAABB(const std::int32_t proxy) const
+{
+    const Bounds& bounds = _nodes[proxy].aabb;
+    return {bounds.min, bounds.max - bounds.min};
+}
+
+std::int32_t DynamicAABBTree::GetHeight() const
+{
+    return _root == NULL_NODE ? 0 : _nodes[_root].height;
+}
+
+std::size_t DynamicAABBTree::GetProxyCount() const
+{
+    return _proxyCount;
+}
+
+std::size_t DynamicAABBTree::GetNodeCapacity() const
+{
+    return _nodes.size();
+}
+
+bool DynamicAABBTree::SegmentOverlaps(const Bounds& b, const sf::Vector2f& from, const sf::Vector2f& direction,
+                                      const float maxFraction)
+{
+    // Slab test, the segment is from + t * direction with t in [0, maxFraction]
+    float tMin = 0.f;
+    float tMax = maxFraction;
+
+    for (const auto& [origin, delta, min, max] :
+         {std::array{from.x, direction.x, b.min.x, b.max.x}, std::array{from.y, direction.y, b.min.y, b.max.y}})
+    {
+        if (std::abs(delta) < 1e-8f)
+        {
+            if (origin < min || origin > max)
+            {
+                return false;
+            }
+            continue;
+        }
+
+        const float inverse = 1.f / delta;
+        float t1 = (min - origin) * inverse;
+        float t2 = (max - origin) * inverse;
+        if (t1 > t2)
+        {
+            std::swap(t1, t2);
+        }
+
+        tMin = std::max(tMin, t1);
+        tMax = std::min(tMax, t2);
+        if (tMin > tMax)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::int32_t DynamicAABBTree::AllocateNode()
+{
+    if (_freeList == NULL_NODE)
+    {
+        _nodes.emplace_back();
+        return static_cast<std::int32_t>(_nodes.size() - 1);
+    }
+
+    const std::int32_t node = _freeList;
+    _freeList = _nodes[node].parent;
+    _nodes[node] = Node{};
+    return node;
+}
+
+void DynamicAABBTree::FreeNode(const std::int32_t node)
+{
+    _nodes[node].parent = _freeList;
+    _nodes[node].height = -1;
+    _freeList = node;
+}
+
+void DynamicAABBTree::InsertLeaf(const std::int32_t leaf)
+{
+    if (_root == NULL_NODE)
+    {
+        _root = leaf;
+        _nodes[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    // Find the best sibling by descending the tree along the cheapest perimeter increase
+    const Bounds leafAABB = _nodes[leaf].aabb;
+    std::int32_t index = _root;
+    while (!_nodes[index].IsLeaf())
+    {
+        const Node& node = _nodes[index];
+
+        const float area = Perimeter(node.aabb);
+        const float combinedArea = Perimeter(Union(node.aabb, leafAABB));
+
+        // Cost of creating a new parent for this node and the new leaf
+        const float cost = 2.f * combinedArea;
+        // Minimum cost of pushing the leaf further down the tree
+        const float inheritanceCost = 2.f * (combinedArea - area);
+
+        const auto descendCost = [&](const std::int32_t child)
+        {
+            const Node& childNode = _nodes[child];
+            const float childCost = Perimeter(Union(childNode.aabb, leafAABB));
+            return (childNode.IsLeaf() ? childCost : childCost - Perimeter(childNode.aabb)) + inheritanceCost;
+        };
+
+        const float cost1 = descendCost(node.child1);
+        const float cost2 = descendCost(node.child2);
+
+        if (cost < cost1 && cost < cost2)
+        {
+            break;
+        }
+
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    const std::int32_t sibling = index;
+
+    // Create a new parent, AllocateNode can grow the vector so no reference is held across it
+    const std::int32_t oldParent = _nodes[sibling].parent;
+    const std::int32_t newParent = AllocateNode();
+    _nodes[newParent].parent = oldParent;
+    _nodes[newParent].aabb = Union(leafAABB, _nodes[sibling].aabb);
+    _nodes[newParent].height = _nodes[sibling].height + 1;
+    _nodes[newParent].child1 = sibling;
+    _nodes[newParent].child2 = leaf;
+    _nodes[sibling].parent = newParent;
+    _nodes[leaf].parent = newParent;
+
+    if (oldParent == NULL_NODE)
+    {
+        _root = newParent;
+    }
+    else if (_nodes[oldParent].child1 == sibling)
+    {
+        _nodes[oldParent].child1 = newParent;
+    }
+    else
+    {
+        _nodes[oldParent].child2 = newParent;
+    }
+
+    // Walk back up the tree fixing heights and AABBs
+    index = _nodes[leaf].parent;
+    while (index != NULL_NODE)
+    {
+        index = Balance(index);
+
+        Node& node = _nodes[index];
+        node.height = 1 + std::max(_nodes[node.child1].height, _nodes[node.child2].height);
+        node.aabb = Union(_nodes[node.child1].aabb, _nodes[node.child2].aabb);
+
+        index = node.parent;
+    }
+}
+
+void DynamicAABBTree::RemoveLeaf(const std::int32_t leaf)
+{
+    if (leaf == _root)
+    {
+        _root = NULL_NODE;
+        return;
+    }
+
+    const std::int32_t parent = _nodes[leaf].parent;
+    const std::int32_t grandParent = _nodes[parent].parent;
+    const std::int32_t sibling = _nodes[parent].child1 == leaf ? _nodes[parent].child2 : _nodes[parent].child1;
+
+    FreeNode(parent);
+
+    if (grandParent == NULL_NODE)
+    {
+        _root = sibling;
+        _nodes[sibling].parent = NULL_NODE;
+        return;
+    }
+
+    // Replace the parent by the sibling
+    if (_nodes[grandParent].child1 == parent)
+    {
+        _nodes[grandParent].child1 = sibling;
+    }
+    else
+    {
+        _nodes[grandParent].child2 = sibling;
+    }
+    _nodes[sibling].parent = grandParent;
+
+    std::int32_t index = grandParent;
+    while (index != NULL_NODE)
+    {
+        index = Balance(index);
+
+        Node& node = _nodes[index];
+        node.height = 1 + std::max(_nodes[node.child1].height, _nodes[node.child2].height);
+        node.aabb = Union(_nodes[node.child1].aabb, _nodes[node.child2].aabb);
+
+        index = node.parent;
+    }
+}
+
+std::int32_t DynamicAABBTree::Balance(const std::int32_t iA)
+{
+    Node& a = _nodes[iA];
+    if (a.IsLeaf() || a.height < 2)
+    {
+        return iA;
+    }
+
+    const std::int32_t iB = a.child1;
+    const std::int32_t iC = a.child2;
+    Node& b = _nodes[iB];
+    Node& c = _nodes[iC];
+
+    const std::int32_t balance = c.height - b.height;
+
+    // Rotate the child up, its deepest grandchild stays under it and the other one moves under A
+    const auto rotate = [&](const std::int32_t iUp, Node& up, const Node& other, const bool upIsChild1)
+    {
+        const std::int32_t iF = up.child1;
+        const std::int32_t iG = up.child2;
+        Node& f = _nodes[iF];
+        Node& g = _nodes[iG];
+
+        up.child1 = iA;
+        up.parent = a.parent;
+        a.parent = iUp;
+
+        if (up.parent == NULL_NODE)
+        {
+            _root = iUp;
+        }
+        else if (_nodes[up.parent].child1 == iA)
+        {
+            _nodes[up.parent].child1 = iUp;
+        }
+        else
+        {
+            _nodes[up.parent].child2 = iUp;
+        }
+
+        const bool keepF = f.height > g.height;
+        const std::int32_t iKept = keepF ? iF : iG;
+        const std::int32_t iMoved = keepF ? iG : iF;
+        Node& kept = keepF ? f : g;
+        Node& moved = keepF ? g : f;
+
+        up.child2 = iKept;
+        (upIsChild1 ? a.child1 : a.child2) = iMoved;
+        moved.parent = iA;
+
+        a.aabb = Union(other.aabb, moved.aabb);
+        up.aabb = Union(a.aabb, kept.aabb);
+        a.height = 1 + std::max(other.height, moved.height);
+        up.height = 1 + std::max(a.height, kept.height);
+    };
+
+    if (balance > 1)
+    {
+        rotate(iC, c, b, false);
+        return iC;
+    }
+
+    if (balance < -1)
+    {
+        rotate(iB, b, c, true);
+        return iB;
+    }
+
+    return iA;
+}
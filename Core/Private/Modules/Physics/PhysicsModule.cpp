@@ -2,15 +2,31 @@
 
 #include "SFE/Modules/Physics/PhysicsModule.h"
 
+#include "Modules/Physics/PhysicsState.h"
+#include "Modules/Physics/Triggers.h"
+
 #include "SFE/GameService.h"
 
 #include "SFE/Modules/Physics/Components/Acceleration.h"
 #include "SFE/Modules/Physics/Components/ColliderShape.h"
+#include "SFE/Modules/Physics/Components/CollisionFilter.h"
 #include "SFE/Modules/Physics/Components/CollisionInfo.h"
+#include "SFE/Modules/Physics/Components/ContinuousCollision.h"
 #include "SFE/Modules/Physics/Components/Friction.h"
 #include "SFE/Modules/Physics/Components/Gravity.h"
+#include "SFE/Modules/Physics/Components/SleepState.h"
+#include "SFE/Modules/Physics/Components/StaticCollider.h"
+#include "SFE/Modules/Physics/Components/Trigger.h"
+#include "SFE/Modules/Physics/Components/TriggerEvents.h"
 #include "SFE/Modules/Physics/Components/Velocity.h"
+#include "SFE/Modules/Physics/Singletons/ActiveTriggers.h"
+#include "SFE/Modules/Physics/Singletons/DeterministicMode.h"
 #include "SFE/Modules/Physics/Singletons/GravitySettings.h"
+#include "SFE/Modules/Physics/Singletons/PhysicsStats.h"
+#include "SFE/Modules/Physics/Singletons/SleepSettings.h"
+#include "SFE/Modules/Physics/Singletons/SpatialQuery.h"
+#include "SFE/Modules/Physics/Singletons/StateChecksum.h"
+#include "SFE/Modules/Physics/Singletons/SubstepSettings.h"
 #include "SFE/Modules/Render/Components/CircleRenderable.h"
 #include "SFE/Modules/Render/Components/Origin.h"
 #include "SFE/Modules/Render/Components/Radius.h"
@@ -19,12 +35,20 @@
 #include "SFE/Modules/Render/Components/Transform.h"
 #include "SFE/Modules/Render/Components/ZOrder.h"
 #include "SFE/PhysicsConstants.h"
+#include "SFE/Utils/Collision.h"
+#include "SFE/Utils/Random.h"
 
 #include <SFML/Graphics/CircleShape.hpp>
 #include <SFML/Graphics/RectangleShape.hpp>
 #include <SFML/Graphics/RenderWindow.hpp>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <limits>
 #include <numbers>
+#include <numeric>
 #include <tracy/Tracy.hpp>
 
 namespace sf
@@ -59,45 +83,972 @@ void MovementSystem(const flecs::iter& it, size_t, Transform& t, const Velocity&
     t.position += v.velocity * it.delta_time();
 }
 
-void CircleCollisionSystem(const flecs::iter& it, const size_t idx, Transform& t, Velocity& v, const Radius& r, const ColliderShape& c)
+std::uint32_t FindIslandRoot(std::vector<std::uint32_t>& parents, std::uint32_t i)
 {
-    ZoneScoped;
+    while (parents[i] != i)
+    {
+        // Path halving keeps the trees flat
+        parents[i] = parents[parents[i]];
+        i = parents[i];
+    }
+    return i;
+}
+
+void WakeIsland(const flecs::world& world, PhysicsState& state, const std::uint32_t island)
+{
+    const auto it = state.sleepingIslands.find(island);
+    if (it == state.sleepingIslands.end())
+    {
+        return;
+    }
+
+    for (const auto& [id, bounds] : it->second)
+    {
+        state.sleepingGrid.Remove(id, bounds);
+        if (!world.is_alive(id))
+        {
+            continue;
+        }
+
+        const flecs::entity e = world.entity(id);
+        e.enable<Velocity>();
+        e.set<SleepState>({});
+    }
+
+    state.sleepingIslands.erase(it);
+}
+
+void PutToSleep(PhysicsState& state, const PhysicsBody& body, const std::uint32_t island)
+{
+    const sf::FloatRect bounds = CircleBounds(body.transform->position, body.radius);
+
+    body.velocity->velocity = {0.f, 0.f};
+    body.sleep->island = island;
+    body.entity.disable<Velocity>();
+
+    state.sleepingGrid.Insert(body.entity.id(), bounds);
+    state.sleepingIslands[island].push_back({.entity = body.entity.id(), .bounds = bounds});
+}
+
+sf::FloatRect SweptCircleBounds(const sf::Vector2f& end, const sf::Vector2f& motion, const float radius)
+{
+    const sf::Vector2f start = end - motion;
+    const sf::Vector2f min = {std::min(start.x, end.x) - radius, std::min(start.y, end.y) - radius};
+    const sf::Vector2f max = {std::max(start.x, end.x) + radius, std::max(start.y, end.y) + radius};
+    return {min, max - min};
+}
 
-    it.world().query<Transform, Velocity, const Radius, const ColliderShape>().each(
-        [&](const flecs::entity other, Transform& t2, Velocity& v2, const Radius& r2, const ColliderShape& c2) {
-            if (other == it.entity(idx))
+void GatherBodies(flecs::iter& it, PhysicsState& state)
+{
+    auto& bodies = state.bodies;
+    bodies.clear();
+    state.continuousBodies.clear();
+
+    // Sleeping bodies have their Velocity toggled off, the query doesn't match them
+    while (it.next())
+    {
+        auto t = it.field<Transform>(0);
+        auto v = it.field<Velocity>(1);
+        const auto r = it.field<const Radius>(2);
+        auto s = it.field<SleepState>(4);
+        const bool continuous = it.is_set(5);
+        const CollisionFilter* filters = it.is_set(6) ? &it.field<const CollisionFilter>(6)[0] : nullptr;
+
+        for (const auto i : it)
+        {
+            PhysicsBody& body = bodies.emplace_back(
+                PhysicsBody{
+                    .entity = it.entity(i),
+                    .transform = &t[i],
+                    .velocity = &v[i],
+                    .sleep = &s[i],
+                    .radius = r[i].radius,
+                    .bounds = CircleBounds(t[i].position, r[i].radius),
+                }
+            );
+
+            if (filters != nullptr)
+            {
+                body.filter = filters[i];
+            }
+
+            if (continuous)
+            {
+                // The MovementSystem already moved the body, the motion is linear so we can rebuild the segment
+                body.motion = v[i].velocity * it.delta_time();
+                body.bounds = SweptCircleBounds(t[i].position, body.motion, r[i].radius);
+                body.continuous = true;
+                state.continuousBodies.push_back(static_cast<std::uint32_t>(bodies.size() - 1));
+            }
+        }
+    }
+}
+
+/**
+ * The gather follows the flecs storage, which changes as entities move between tables. In deterministic mode the
+ * bodies are put back in entity order, so the broadphase and everything after it sees the same input on every run.
+ */
+void SortBodiesByEntity(PhysicsState& state)
+{
+    ZoneScopedN("PhysicsModule::SortBodiesByEntity");
+
+    std::ranges::sort(state.bodies, {}, [](const PhysicsBody& body) { return body.entity.id(); });
+
+    state.continuousBodies.clear();
+    for (std::uint32_t i = 0; i < state.bodies.size(); ++i)
+    {
+        if (state.bodies[i].continuous)
+        {
+            state.continuousBodies.push_back(i);
+        }
+    }
+}
+
+/**
+ * Pairs come out of the sweep in X order, in deterministic mode they are resolved in body order instead.
+ */
+void SortPairs(PhysicsState& state)
+{
+    ZoneScopedN("PhysicsModule::SortPairs");
+
+    for (auto& [a, b] : state.pairs)
+    {
+        if (b < a)
+        {
+            std::swap(a, b);
+        }
+    }
+    std::ranges::sort(state.pairs);
+}
+
+/**
+ * Sort and sweep on the X axis, only the awake bodies take part. The CollisionFilter is applied here so filtered pairs
+ * never reach the narrowphase, and bodies that can't collide with anything don't even enter the sweep.
+ *
+ * @return the number of overlapping pairs before filtering
+ */
+int FindAwakePairs(PhysicsState& state)
+{
+    ZoneScopedN("PhysicsModule::Broadphase");
+
+    const auto& bodies = state.bodies;
+    auto& order = state.order;
+    auto& pairs = state.pairs;
+
+    order.clear();
+    for (std::uint32_t i = 0; i < bodies.size(); ++i)
+    {
+        if (bodies[i].filter.layer != CollisionLayer::None && bodies[i].filter.mask != CollisionLayer::None)
+        {
+            order.push_back(i);
+        }
+    }
+
+    // Ties are broken by index so the order is the same whatever the sort implementation
+    std::ranges::sort(order, [&bodies](const std::uint32_t a, const std::uint32_t b) {
+        const float ax = bodies[a].bounds.position.x;
+        const float bx = bodies[b].bounds.position.x;
+        return ax < bx || (ax == bx && a < b);
+    });
+
+    int overlapping = 0;
+    pairs.clear();
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        const PhysicsBody& a = bodies[order[i]];
+        const float maxX = a.bounds.position.x + a.bounds.size.x;
+
+        for (std::size_t j = i + 1; j < order.size(); ++j)
+        {
+            const PhysicsBody& b = bodies[order[j]];
+            if (b.bounds.position.x > maxX)
+            {
+                break;
+            }
+
+            if (a.bounds.position.y > b.bounds.position.y + b.bounds.size.y ||
+                b.bounds.position.y > a.bounds.position.y + a.bounds.size.y)
+            {
+                continue;
+            }
+
+            overlapping++;
+            if (CanCollide(a.filter, b.filter))
+            {
+                pairs.emplace_back(order[i], order[j]);
+            }
+        }
+    }
+
+    return overlapping;
+}
+
+/**
+ * Awake bodies touching a sleeping body wake its whole island. The woken bodies take part from the next step on.
+ */
+void WakeTouchedIslands(const flecs::world& world, PhysicsState& state)
+{
+    if (state.sleepingGrid.IsEmpty())
+    {
+        return;
+    }
+
+    auto& woken = state.wokenIslands;
+    woken.clear();
+
+    for (const PhysicsBody& body : state.bodies)
+    {
+        state.sleepingGrid.Query(body.bounds, [&](const SpatialHashGrid::Entry& entry) {
+            if (!world.is_alive(entry.id))
             {
                 return;
             }
 
-            // TODO: Implement multiple types of colliders (circle, rectangle, etc)
-            const sf::Vector2f difference = t2.position - t.position;
-            const float distance = difference.length();
-            const float sumOfRadii = r.radius + r2.radius;
-            if (distance > sumOfRadii || distance == 0.f)
+            const flecs::entity other = world.entity(entry.id);
+            if (const auto* filter = other.try_get<CollisionFilter>(); filter == nullptr || CanCollide(body.filter, *filter))
+            {
+                woken.push_back(other.get<SleepState>().island);
+            }
+        });
+    }
+
+    std::ranges::sort(woken);
+    const auto duplicates = std::ranges::unique(woken);
+    woken.erase(duplicates.begin(), duplicates.end());
+
+    for (const std::uint32_t island : woken)
+    {
+        WakeIsland(world, state, island);
+    }
+}
+
+/**
+ * First time of impact, in [0, 1], of two circles separated by `start` and moving apart by `motion` over the step.
+ *
+ * @return 1 when they don't hit, or if they already overlap at the start (the contact resolution handles those)
+ */
+float CircleTimeOfImpact(const sf::Vector2f& start, const sf::Vector2f& motion, const float sumOfRadii)
+{
+    const float a = motion.dot(motion);
+    const float b = 2.f * start.dot(motion);
+    const float c = start.dot(start) - sumOfRadii * sumOfRadii;
+    if (c <= 0.f || a == 0.f || b >= 0.f)
+    {
+        return 1.f;
+    }
+
+    const float discriminant = b * b - 4.f * a * c;
+    if (discriminant < 0.f)
+    {
+        return 1.f;
+    }
+
+    const float t = (-b - std::sqrt(discriminant)) / (2.f * a);
+    return std::clamp(t, 0.f, 1.f);
+}
+
+/**
+ * Same as CircleTimeOfImpact against a box, by casting the center against the box grown by the radius. The grown box
+ * has square corners so an impact near a corner is reported slightly early, which only stops the body a bit sooner.
+ */
+float BoxTimeOfImpact(const sf::Vector2f& start, const sf::Vector2f& motion, const sf::FloatRect& box, const float radius)
+{
+    const sf::Vector2f min = box.position - sf::Vector2f{radius, radius};
+    const sf::Vector2f max = box.position + box.size + sf::Vector2f{radius, radius};
+
+    float tMin = 0.f;
+    float tMax = 1.f;
+    for (const auto& [origin, delta, low, high] :
+         {std::array{start.x, motion.x, min.x, max.x}, std::array{start.y, motion.y, min.y, max.y}})
+    {
+        if (delta == 0.f)
+        {
+            if (origin < low || origin > high)
+            {
+                return 1.f;
+            }
+            continue;
+        }
+
+        float t1 = (low - origin) / delta;
+        float t2 = (high - origin) / delta;
+        if (t1 > t2)
+        {
+            std::swap(t1, t2);
+        }
+
+        tMin = std::max(tMin, t1);
+        tMax = std::min(tMax, t2);
+        if (tMin > tMax)
+        {
+            return 1.f;
+        }
+    }
+
+    // Already overlapping at the start, the contact resolution handles it
+    return tMin <= 0.f ? 1.f : tMin;
+}
+
+/**
+ * Swept circle test for the bodies flagged ContinuousCollision, against the broadphase candidates of their swept
+ * bounds, the sleeping bodies and the statics along the way. Other bodies are considered at their end position.
+ *
+ * Each continuous body is rewound to its earliest impact and the regular contact resolution bounces it. The rest of
+ * the motion is dropped for this step, which is good enough at game speeds and keeps the cost to the flagged bodies.
+ */
+int SolveTimeOfImpact(const flecs::world& world, PhysicsState& state)
+{
+    if (state.continuousBodies.empty())
+    {
+        return 0;
+    }
+
+    ZoneScopedN("PhysicsModule::ContinuousCollision");
+
+    auto& bodies = state.bodies;
+    auto& toi = state.timeOfImpact;
+    toi.assign(bodies.size(), 1.f);
+
+    for (const auto& [a, b] : state.pairs)
+    {
+        const PhysicsBody& bodyA = bodies[a];
+        const PhysicsBody& bodyB = bodies[b];
+        if (!bodyA.continuous && !bodyB.continuous)
+        {
+            continue;
+        }
+
+        const sf::Vector2f startA = bodyA.transform->position - bodyA.motion;
+        const sf::Vector2f startB = bodyB.transform->position - bodyB.motion;
+        const float t = CircleTimeOfImpact(startB - startA, bodyB.motion - bodyA.motion, bodyA.radius + bodyB.radius);
+
+        // Only rewind the swept bodies, the others didn't move through anything
+        if (bodyA.continuous)
+        {
+            toi[a] = std::min(toi[a], t);
+        }
+        if (bodyB.continuous)
+        {
+            toi[b] = std::min(toi[b], t);
+        }
+    }
+
+    auto& woken = state.wokenIslands;
+    woken.clear();
+
+    int hits = 0;
+    for (const std::uint32_t i : state.continuousBodies)
+    {
+        PhysicsBody& body = bodies[i];
+        const sf::Vector2f start = body.transform->position - body.motion;
+
+        state.sleepingGrid.Query(body.bounds, [&](const SpatialHashGrid::Entry& entry) {
+            const float otherRadius = entry.bounds.size.x * 0.5f;
+            const sf::Vector2f otherCenter = entry.bounds.position + sf::Vector2f{otherRadius, otherRadius};
+            const float t = CircleTimeOfImpact(otherCenter - start, -body.motion, body.radius + otherRadius);
+            if (t >= toi[i] || !world.is_alive(entry.id))
             {
-                // No collision :(
                 return;
             }
 
-            const sf::Vector2f collisionNormal = difference.normalized();
-            const sf::Vector2f relativeVelocity = v2.velocity - v.velocity;
-            const float velocityNormal = relativeVelocity.dot(collisionNormal);
+            const flecs::entity other = world.entity(entry.id);
+            if (const auto* filter = other.try_get<CollisionFilter>(); filter == nullptr || CanCollide(body.filter, *filter))
+            {
+                toi[i] = t;
+                woken.push_back(other.get<SleepState>().island);
+            }
+        });
 
-            if (velocityNormal > 0.f)
+        state.statics.Query(body.bounds, [&](const StaticShape& shape) {
+            if (!CanCollide(body.filter, shape.filter))
             {
                 return;
             }
 
-            v.velocity += collisionNormal * velocityNormal;
-            v2.velocity -= collisionNormal * velocityNormal;
+            const float t = shape.IsCircle()
+                                ? CircleTimeOfImpact(shape.center - start, -body.motion, body.radius + shape.radius)
+                                : BoxTimeOfImpact(start, body.motion, shape.bounds, body.radius);
+            toi[i] = std::min(toi[i], t);
+        });
+
+        if (toi[i] < 1.f)
+        {
+            body.transform->position = start + body.motion * toi[i];
+            body.bounds = CircleBounds(body.transform->position, body.radius);
+            hits++;
+        }
+    }
+
+    for (const std::uint32_t island : woken)
+    {
+        WakeIsland(world, state, island);
+    }
+
+    return hits;
+}
+
+/**
+ * @return true when the bodies are touching, even if they are already moving apart
+ */
+bool ResolveCircleContact(const PhysicsBody& a, const PhysicsBody& b)
+{
+    // TODO: Implement multiple types of colliders (circle, rectangle, etc)
+    Transform& t = *a.transform;
+    Transform& t2 = *b.transform;
+    Velocity& v = *a.velocity;
+    Velocity& v2 = *b.velocity;
+
+    const sf::Vector2f difference = t2.position - t.position;
+    const float distance = difference.length();
+    const float sumOfRadii = a.radius + b.radius;
+    if (distance > sumOfRadii || distance == 0.f)
+    {
+        // No collision :(
+        return false;
+    }
+
+    const sf::Vector2f collisionNormal = difference.normalized();
+    const sf::Vector2f relativeVelocity = v2.velocity - v.velocity;
+    const float velocityNormal = relativeVelocity.dot(collisionNormal);
+
+    if (velocityNormal > 0.f)
+    {
+        return true;
+    }
+
+    v.velocity += collisionNormal * velocityNormal;
+    v2.velocity -= collisionNormal * velocityNormal;
+
+    // Move the balls outside each others
+    const float overlap = sumOfRadii - distance;
+    t.position -= collisionNormal * overlap * 0.5f;
+    t2.position += collisionNormal * overlap * 0.5f;
+
+    return true;
+}
+
+/**
+ * Statics don't move, so the body takes the whole correction and bounces off.
+ *
+ * @return true when the body is touching the static
+ */
+bool ResolveStaticContact(const PhysicsBody& body, const StaticShape& shape)
+{
+    Transform& t = *body.transform;
+    Velocity& v = *body.velocity;
+
+    sf::Vector2f normal;
+    float penetration;
+    if (shape.IsCircle())
+    {
+        const sf::Vector2f difference = t.position - shape.center;
+        const float distance = difference.length();
+        const float sumOfRadii = body.radius + shape.radius;
+        if (distance > sumOfRadii || distance == 0.f)
+        {
+            return false;
+        }
+
+        normal = difference / distance;
+        penetration = sumOfRadii - distance;
+    }
+    else
+    {
+        const CollisionInfo info = Collision::CheckAABBCircleCollision(shape.bounds, t.position, body.radius);
+        if (!info.hasCollision)
+        {
+            return false;
+        }
+
+        normal = info.normal;
+        penetration = info.penetrationDepth;
+    }
+
+    t.position += normal * penetration;
+
+    const float velocityNormal = v.velocity.dot(normal);
+    if (velocityNormal < 0.f)
+    {
+        v.velocity -= normal * (2.f * velocityNormal);
+    }
+
+    return true;
+}
+
+/**
+ * Only the awake bodies look for statics, the statics never look for anything.
+ *
+ * @return the number of contacts with a static
+ */
+int ResolveStaticContacts(PhysicsState& state)
+{
+    if (state.statics.IsEmpty())
+    {
+        return 0;
+    }
+
+    ZoneScopedN("PhysicsModule::StaticContacts");
+
+    int contacts = 0;
+    for (const PhysicsBody& body : state.bodies)
+    {
+        if (body.filter.layer == CollisionLayer::None || body.filter.mask == CollisionLayer::None)
+        {
+            continue;
+        }
+
+        state.statics.Query(CircleBounds(body.transform->position, body.radius), [&](const StaticShape& shape) {
+            if (CanCollide(body.filter, shape.filter) && ResolveStaticContact(body, shape))
+            {
+                contacts++;
+            }
+        });
+    }
+
+    return contacts;
+}
+
+void RebuildStatics(const flecs::world& world, PhysicsState& state)
+{
+    if (!state.staticsDirty)
+    {
+        return;
+    }
+
+    ZoneScopedN("PhysicsModule::RebuildStatics");
+
+    std::vector<StaticShape> shapes;
+    world.query_builder<const Transform, const ColliderShape>().with<StaticCollider>().build().each(
+        [&shapes](const flecs::entity e, const Transform& t, const ColliderShape& c) {
+            StaticShape shape;
+            shape.entity = e.id();
+            if (const auto* filter = e.try_get<CollisionFilter>(); filter != nullptr)
+            {
+                shape.filter = *filter;
+            }
+
+            if (c.shape == Shape::Circle)
+            {
+                const auto* r = e.try_get<Radius>();
+                if (r == nullptr)
+                {
+                    return;
+                }
+
+                shape.center = t.position;
+                shape.radius = r->radius;
+                shape.bounds = CircleBounds(t.position, r->radius);
+            }
+            else
+            {
+                const auto* s = e.try_get<Size>();
+                if (s == nullptr)
+                {
+                    return;
+                }
+
+                shape.bounds = {t.position, s->size};
+                shape.center = t.position + s->size / 2.f;
+            }
 
-            // Move the balls outside each others
-            const float overlap = sumOfRadii - distance;
-            t.position -= collisionNormal * overlap * 0.5f;
-            t2.position += collisionNormal * overlap * 0.5f;
+            shapes.push_back(shape);
         }
     );
+
+    state.statics.Build(std::move(shapes));
+    state.staticsDirty = false;
+}
+
+/**
+ * Bodies are grouped in islands of touching bodies, an island only falls asleep when all its bodies rested long
+ * enough. This prevents putting a body to sleep while something is still pushing it.
+ */
+void UpdateSleep(PhysicsState& state, const SleepSettings& settings, const float dt)
+{
+    ZoneScopedN("PhysicsModule::UpdateSleep");
+
+    const auto& bodies = state.bodies;
+    const float thresholdSquared = settings.linearThreshold * settings.linearThreshold;
+    for (const PhysicsBody& body : bodies)
+    {
+        if (body.velocity->velocity.lengthSquared() > thresholdSquared)
+        {
+            body.sleep->idleTime = 0.f;
+        }
+        else
+        {
+            body.sleep->idleTime += dt;
+        }
+    }
+
+    // Velocity is only toggled off when the step is merged, a body put to sleep before the last substep would still
+    // be gathered by the next one and put to sleep again
+    if (!settings.enabled || !state.lastSubstep)
+    {
+        return;
+    }
+
+    const auto count = static_cast<std::uint32_t>(bodies.size());
+
+    auto& parents = state.islandParents;
+    parents.resize(count);
+    std::iota(parents.begin(), parents.end(), 0u);
+    for (const auto& [a, b] : state.contacts)
+    {
+        parents[FindIslandRoot(parents, a)] = FindIslandRoot(parents, b);
+    }
+
+    // The island rests as long as its most restless body
+    auto& idle = state.islandIdle;
+    idle.assign(count, std::numeric_limits<float>::max());
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        const std::uint32_t root = FindIslandRoot(parents, i);
+        idle[root] = std::min(idle[root], bodies[i].sleep->idleTime);
+    }
+
+    auto& islandIds = state.islandIds;
+    islandIds.assign(count, 0);
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        const std::uint32_t root = FindIslandRoot(parents, i);
+        if (idle[root] < settings.timeToSleep)
+        {
+            continue;
+        }
+
+        if (islandIds[root] == 0)
+        {
+            islandIds[root] = state.nextIsland++;
+        }
+
+        PutToSleep(state, bodies[i], islandIds[root]);
+    }
+}
+
+void CircleCollisionSystem(flecs::iter& it)
+{
+    ZoneScoped;
+
+    const flecs::world world = it.world();
+    auto& state = world.get_mut<PhysicsState>();
+
+    const auto broadphaseStart = std::chrono::steady_clock::now();
+
+    RebuildStatics(world, state);
+    GatherBodies(it, state);
+
+    const bool deterministic = world.get<DeterministicMode>().enabled;
+    if (deterministic)
+    {
+        SortBodiesByEntity(state);
+    }
+
+    const int pairsBeforeFilter = FindAwakePairs(state);
+    if (deterministic)
+    {
+        SortPairs(state);
+    }
+
+    const auto narrowphaseStart = std::chrono::steady_clock::now();
+
+    const int timeOfImpactHits = SolveTimeOfImpact(world, state);
+    WakeTouchedIslands(world, state);
+
+    {
+        ZoneScopedN("PhysicsModule::Narrowphase");
+
+        state.contacts.clear();
+        for (const auto& [a, b] : state.pairs)
+        {
+            if (ResolveCircleContact(state.bodies[a], state.bodies[b]))
+            {
+                state.contacts.emplace_back(a, b);
+            }
+        }
+    }
+
+    const int staticContacts = ResolveStaticContacts(state);
+
+    const auto narrowphaseEnd = std::chrono::steady_clock::now();
+
+    UpdateSleep(state, world.get<SleepSettings>(), it.delta_time());
+
+    auto& stats = world.get_mut<PhysicsStats>();
+    stats.awakeBodies = static_cast<int>(state.bodies.size());
+    stats.sleepingBodies = static_cast<int>(state.sleepingGrid.Size());
+    stats.pairsBeforeFilter = pairsBeforeFilter;
+    stats.pairsAfterFilter = static_cast<int>(state.pairs.size());
+    stats.contacts = static_cast<int>(state.contacts.size());
+    stats.staticColliders = static_cast<int>(state.statics.Size());
+    stats.staticContacts = staticContacts;
+    stats.timeOfImpactHits = timeOfImpactHits;
+    stats.broadphaseTime = narrowphaseStart - broadphaseStart;
+    stats.narrowphaseTime = narrowphaseEnd - narrowphaseStart;
+}
+
+int ComputeSubsteps(const float displacementRatio, const SubstepSettings& settings)
+{
+    if (settings.maxDisplacementRatio <= 0.f)
+    {
+        return std::max(1, settings.maxSubsteps);
+    }
+
+    const int substeps = static_cast<int>(std::ceil(displacementRatio / settings.maxDisplacementRatio));
+    return std::clamp(substeps, 1, std::max(1, settings.maxSubsteps));
+}
+
+/**
+ * Runs the integration and collision systems once per substep. The triggers only look at the final positions, so
+ * their events cover the whole frame whatever the number of substeps.
+ */
+void PhysicsStepSystem(flecs::iter& it)
+{
+    ZoneScoped;
+
+    const flecs::world world = it.world();
+    const float dt = it.delta_time();
+
+    // Compared squared, the square root is only taken once for the fastest body
+    float maxSpeedOverRadiusSquared = 0.f;
+    while (it.next())
+    {
+        const auto v = it.field<const Velocity>(0);
+        const auto r = it.field<const Radius>(1);
+        for (const auto i : it)
+        {
+            if (r[i].radius > 0.f)
+            {
+                maxSpeedOverRadiusSquared =
+                    std::max(maxSpeedOverRadiusSquared, v[i].velocity.lengthSquared() / (r[i].radius * r[i].radius));
+            }
+        }
+    }
+
+    const int substeps = ComputeSubsteps(std::sqrt(maxSpeedOverRadiusSquared) * dt, world.get<SubstepSettings>());
+    const float substepTime = dt / static_cast<float>(substeps);
+
+    auto& state = world.get_mut<PhysicsState>();
+    for (int substep = 0; substep < substeps; ++substep)
+    {
+        state.lastSubstep = substep == substeps - 1;
+        for (const flecs::system& system : state.stepSystems)
+        {
+            system.run(substepTime);
+        }
+    }
+
+    const int triggerPairs = Triggers::Update(world, state);
+
+    auto& stats = world.get_mut<PhysicsStats>();
+    stats.substeps = substeps;
+    stats.triggerPairs = triggerPairs;
+}
+
+std::uint64_t Mix(std::uint64_t x)
+{
+    // splitmix64 finalizer
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+/**
+ * Hashes the raw bits of the component, two floats at a time, seeded by the entity so identical components on
+ * different entities don't cancel out.
+ */
+template <typename T>
+std::uint64_t HashComponent(const flecs::entity_t entity, const T& component)
+{
+    static_assert(sizeof(T) % sizeof(float) == 0, "Only components made of floats can be hashed");
+
+    std::array<std::uint32_t, (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t) * 2> words = {};
+    std::memcpy(words.data(), &component, sizeof(T));
+
+    std::uint64_t hash = Mix(entity);
+    for (std::size_t i = 0; i < words.size(); i += 2)
+    {
+        hash = Mix(hash ^ (static_cast<std::uint64_t>(words[i]) << 32 | words[i + 1]));
+    }
+    return hash;
+}
+
+/**
+ * The entities are combined with a sum so the checksum doesn't depend on the iteration order.
+ */
+template <typename T>
+void AccumulateChecksum(flecs::iter& it, const bool reset)
+{
+    const flecs::world world = it.world();
+    if (!world.get<DeterministicMode>().enabled)
+    {
+        it.fini();
+        return;
+    }
+
+    ZoneScopedN("PhysicsModule::StateChecksum");
+
+    auto& checksum = world.get_mut<StateChecksum>();
+    if (reset)
+    {
+        checksum = {};
+    }
+
+    while (it.next())
+    {
+        const auto components = it.field<const T>(0);
+        for (const auto i : it)
+        {
+            checksum.hash += HashComponent(it.entity(i).id(), components[i]);
+        }
+        checksum.entities += static_cast<int>(it.count());
+    }
+}
+
+void ChecksumTransformSystem(flecs::iter& it)
+{
+    AccumulateChecksum<Transform>(it, true);
+}
+
+void ChecksumVelocitySystem(flecs::iter& it)
+{
+    AccumulateChecksum<Velocity>(it, false);
+}
+
+void ApplyDeterministicMode(const flecs::entity, const DeterministicMode& mode)
+{
+    if (mode.enabled)
+    {
+        Random::Seed(mode.seed);
+    }
+}
+
+void WakeOnAcceleration(const flecs::entity e, const Acceleration& a, const SleepState& s)
+{
+    if (s.island == 0 || (a.acceleration.x == 0.f && a.acceleration.y == 0.f))
+    {
+        return;
+    }
+
+    WakeIsland(e.world(), e.world().get_mut<PhysicsState>(), s.island);
+}
+
+void ForgetSleepingBody(const flecs::entity e, const SleepState& s)
+{
+    if (s.island == 0)
+    {
+        return;
+    }
+
+    // The state might already be gone when the world is shutting down
+    auto* state = e.world().try_get_mut<PhysicsState>();
+    if (state == nullptr)
+    {
+        return;
+    }
+
+    const auto island = state->sleepingIslands.find(s.island);
+    if (island == state->sleepingIslands.end())
+    {
+        return;
+    }
+
+    auto& members = island->second;
+    if (const auto member = std::ranges::find(members, e.id(), &SleepingBody::entity); member != members.end())
+    {
+        state->sleepingGrid.Remove(member->entity, member->bounds);
+        members.erase(member);
+    }
+}
+
+void RegisterTrigger(const flecs::entity e, const Trigger& trigger, const Transform& t)
+{
+    Triggers::Register(e.world().get_mut<PhysicsState>(), e.id(), {t.position, trigger.size});
+}
+
+void UnregisterTrigger(const flecs::entity e, const Trigger&)
+{
+    if (auto* state = e.world().try_get_mut<PhysicsState>(); state != nullptr)
+    {
+        Triggers::Unregister(*state, e.id());
+    }
+}
+
+void MarkStaticsDirty(const flecs::entity e)
+{
+    // The state might already be gone when the world is shutting down
+    if (auto* state = e.world().try_get_mut<PhysicsState>(); state != nullptr)
+    {
+        state->staticsDirty = true;
+    }
+}
+
+std::uint32_t LayerOf(const flecs::entity e)
+{
+    const auto* filter = e.try_get<CollisionFilter>();
+    return filter != nullptr ? filter->layer : CollisionLayer::Default;
+}
+
+/**
+ * Indexes the entity when it is something to query: a collider, or an entity given a CollisionFilter. Sprites, texts
+ * and the other entities that only have a Transform and a Radius or a Size stay out of the tree.
+ */
+void IndexEntity(const flecs::entity e)
+{
+    if (!e.has<ColliderShape>() && !e.has<CollisionFilter>())
+    {
+        return;
+    }
+
+    const auto* t = e.try_get<Transform>();
+    if (t == nullptr)
+    {
+        return;
+    }
+
+    // The radius wins when an entity has both
+    auto& spatialQuery = e.world().get_mut<SpatialQuery>();
+    if (const auto* r = e.try_get<Radius>(); r != nullptr)
+    {
+        spatialQuery.SetCircle(e.id(), t->position, r->radius, LayerOf(e));
+    }
+    else if (const auto* s = e.try_get<Size>(); s != nullptr)
+    {
+        spatialQuery.SetBox(e.id(), {t->position, s->size}, LayerOf(e));
+    }
+}
+
+void IndexShape(const flecs::entity e, const Transform&)
+{
+    IndexEntity(e);
+}
+
+void IndexCollider(const flecs::entity e, const ColliderShape&)
+{
+    IndexEntity(e);
+}
+
+void IndexFiltered(const flecs::entity e, const CollisionFilter&)
+{
+    // Also moves an indexed entity to its new layer
+    IndexEntity(e);
+}
+
+void RefitSpatialQuery(const flecs::iter& it, const std::size_t index, const Transform& t)
+{
+    // Most entities stay inside their fat AABB, the tree is not touched for them
+    it.world().get_mut<SpatialQuery>().Move(it.entity(index), t.position);
+}
+
+void RemoveFromIndex(const flecs::entity e, const Transform&)
+{
+    if (auto* spatialQuery = e.world().try_get_mut<SpatialQuery>(); spatialQuery != nullptr)
+    {
+        spatialQuery->Remove(e.id());
+    }
 }
 
 void AddDebugCircleCollider(const flecs::entity& e, const Transform& t, const Origin& o, const Radius& r, const ColliderShape& c)
@@ -148,16 +1099,86 @@ namespace Core::Modules
 PhysicsModule::PhysicsModule(const flecs::world& world)
 {
     world.component<Velocity>().add(flecs::CanToggle);
+    world.component<SleepState>();
+    world.component<ContinuousCollision>();
+    world.component<CollisionFilter>();
+    world.component<TriggerEvents>();
+    world.component<StaticCollider>();
+    world.component<Trigger>().add(flecs::With, world.component<TriggerEvents>());
+    // Every collider can fall asleep
+    world.component<ColliderShape>().add(flecs::With, world.component<SleepState>());
 
     world.set<GravitySettings>(
         {.gravity = PhysicsConstants::NO_GRAVITY, .pixelsPerCentimeter = PhysicsConstants::PIXELS_PER_CENTIMETER}
     );
+    world.set<SleepSettings>({});
+    world.set<PhysicsStats>({});
+    world.set<ActiveTriggers>({});
+    world.set<PhysicsState>({});
+    world.set<StateChecksum>({});
+    world.set<SpatialQuery>(SpatialQuery(world.c_ptr()));
 
-    world.system<const Gravity, Velocity>("GravitySystem").each(GravitySystem);
-    world.system<const Friction, Velocity>("FrictionSystem").each(FrictionSystem);
+    world.set<SubstepSettings>({});
+
+    // The step systems have no phase, the PhysicsStepSystem runs them once per substep
+    world.get_mut<PhysicsState>().stepSystems = {
+        world.system<const Gravity, Velocity>("GravitySystem").kind(0).each(GravitySystem),
+        world.system<const Friction, Velocity>("FrictionSystem").kind(0).each(FrictionSystem),
+        world.system<Transform, const Velocity>("MovementSystem").kind(0).without<StaticCollider>().each(MovementSystem),
+        world.system<Transform, Velocity, const Radius, const ColliderShape, SleepState>("CircleCollisionSystem")
+            .kind(0)
+            .with<ContinuousCollision>()
+            .optional()
+            .with<CollisionFilter>()
+            .in()
+            .optional()
+            .without<StaticCollider>()
+            .run(CircleCollisionSystem),
+    };
+    // The acceleration is consumed once applied, so it gets the whole frame before the substeps instead of the first
+    // substep only
     world.system<Acceleration, Velocity>("AccelerationSystem").each(AccelerationSystem);
-    world.system<Transform, const Velocity>("MovementSystem").each(MovementSystem);
-    world.system<Transform, Velocity, const Radius, const ColliderShape>("CircleCollisionSystem").each(CircleCollisionSystem);
+    world.system<const Velocity, const Radius>("PhysicsStepSystem").without<StaticCollider>().run(PhysicsStepSystem);
+
+    // The checksum is taken once the frame is simulated, before rendering
+    world.system<const Transform>("ChecksumTransformSystem").kind(flecs::PreStore).run(ChecksumTransformSystem);
+    world.system<const Velocity>("ChecksumVelocitySystem").kind(flecs::PreStore).run(ChecksumVelocitySystem);
+
+    // A sleeping body is woken up by an applied acceleration, and forgotten when removed
+    world.observer<const Acceleration, const SleepState>("WakeOnAcceleration").event(flecs::OnSet).each(WakeOnAcceleration);
+    world.observer<const SleepState>("ForgetSleepingBody").event(flecs::OnRemove).each(ForgetSleepingBody);
+
+    // Triggers are static, they are baked in their grid whenever their Trigger or Transform is set
+    world.observer<const Trigger, const Transform>("RegisterTrigger").event(flecs::OnSet).each(RegisterTrigger);
+    world.observer<const Trigger>("UnregisterTrigger").event(flecs::OnRemove).each(UnregisterTrigger);
+
+    world.observer<const DeterministicMode>("ApplyDeterministicMode").event(flecs::OnSet).each(ApplyDeterministicMode);
+    world.set<DeterministicMode>({});
+
+    // Statics are baked once, any change to one of them rebuilds the whole set on the next step
+    world.observer("MarkStaticsDirty")
+        .with<StaticCollider>()
+        .with<Transform>()
+        .with<ColliderShape>()
+        .event(flecs::OnAdd)
+        .event(flecs::OnSet)
+        .event(flecs::OnRemove)
+        .each(MarkStaticsDirty);
+
+    // The spatial query indexes the circles and boxes of the colliders and of the entities with a CollisionFilter
+    world.observer<const Transform>("IndexCircle").with<Radius>().event(flecs::OnSet).each(IndexShape);
+    world.observer<const Transform>("IndexBox").with<Size>().event(flecs::OnSet).each(IndexShape);
+    world.observer<const ColliderShape>("IndexCollider").event(flecs::OnSet).each(IndexCollider);
+    world.observer<const CollisionFilter>("IndexFiltered").event(flecs::OnSet).each(IndexFiltered);
+    world.observer<const Transform>("RemoveFromIndex").event(flecs::OnRemove).each(RemoveFromIndex);
+
+    // Whatever moved them, the indexed entities are refit once the frame is simulated
+    world.system<const Transform>("RefitSpatialQuery")
+        .with<ColliderShape>()
+        .or_()
+        .with<CollisionFilter>()
+        .kind(flecs::OnValidate)
+        .each(RefitSpatialQuery);
 
     // Debug rendering
     //world.system<const Transform, const Origin, const Radius, const ColliderShape>("AddDebugCircleCollider").each(AddDebugCircleCollider);
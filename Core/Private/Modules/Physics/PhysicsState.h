@@ -0,0 +1,94 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include "Modules/Physics/SpatialHashGrid.h"
+#include "Modules/Physics/StaticBVH.h"
+
+#include "SFE/Modules/Physics/Components/CollisionFilter.h"
+#include "SFE/Modules/Physics/Components/SleepState.h"
+#include "SFE/Modules/Physics/Components/Velocity.h"
+#include "SFE/Modules/Render/Components/Transform.h"
+
+#include <SFML/Graphics/Rect.hpp>
+
+#include <flecs.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <cstdint>
+
+using TriggerPair = std::pair<flecs::entity_t, flecs::entity_t>;
+
+inline sf::FloatRect CircleBounds(const sf::Vector2f& center, const float radius)
+{
+    return {center - sf::Vector2f{radius, radius}, {2.f * radius, 2.f * radius}};
+}
+
+inline bool CanCollide(const CollisionFilter& a, const CollisionFilter& b)
+{
+    return (a.layer & b.mask) != 0 && (b.layer & a.mask) != 0;
+}
+
+/**
+ * @brief A body gathered for the current physics step. The pointers reference the flecs storage and are only valid
+ * during the system that gathered them.
+ */
+struct PhysicsBody
+{
+    flecs::entity entity;
+    Transform* transform = nullptr;
+    Velocity* velocity = nullptr;
+    SleepState* sleep = nullptr;
+    float radius = 0.f;
+    // Swept over the whole motion of the step for continuous bodies
+    sf::FloatRect bounds;
+    sf::Vector2f motion;
+    bool continuous = false;
+    CollisionFilter filter;
+};
+
+struct SleepingBody
+{
+    flecs::entity_t entity = 0;
+    sf::FloatRect bounds;
+};
+
+/**
+ * @brief Internal per-world physics state: the scratch buffers reused every step and the persistent sets.
+ */
+struct PhysicsState
+{
+    // --- Integration and collision systems, run once per substep ---
+    std::vector<flecs::system> stepSystems;
+    // The islands only fall asleep on the last substep of the frame
+    bool lastSubstep = true;
+
+    // --- Per step scratch, kept around so we don't allocate every frame ---
+    std::vector<PhysicsBody> bodies;
+    std::vector<std::uint32_t> order;
+    std::vector<std::uint32_t> continuousBodies;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> contacts;
+    std::vector<std::uint32_t> wokenIslands;
+    std::vector<float> timeOfImpact;
+    std::vector<std::uint32_t> islandParents;
+    std::vector<float> islandIdle;
+    std::vector<std::uint32_t> islandIds;
+
+    // --- Sleeping bodies, only touched when an island falls asleep or wakes up ---
+    SpatialHashGrid sleepingGrid;
+    std::unordered_map<std::uint32_t, std::vector<SleepingBody>> sleepingIslands;
+    std::uint32_t nextIsland = 1;
+
+    // --- Static colliders, rebuilt from scratch when one is added, removed or moved ---
+    StaticBVH statics;
+    bool staticsDirty = true;
+
+    // --- Triggers, the (trigger, body) pairs are kept sorted so consecutive steps can be diffed ---
+    SpatialHashGrid triggerGrid;
+    std::unordered_map<flecs::entity_t, sf::FloatRect> triggerBounds;
+    std::vector<TriggerPair> triggerPairs;
+    std::vector<TriggerPair> currentTriggerPairs;
+};
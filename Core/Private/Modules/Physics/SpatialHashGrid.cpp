@@ -0,0 +1,84 @@
+// Copyright (c) Eric Jeker 2025.
+
+#include "Modules/Physics/SpatialHashGrid.h"
+
+#include <algorithm>
+#include <cassert>
+
+SpatialHashGrid::SpatialHashGrid(const float cellSize)
+    : _cellSize(cellSize)
+{
+    assert(cellSize > 0.f && "Cell size must be greater than 0");
+}
+
+void SpatialHashGrid::Insert(const flecs::entity_t id, const sf::FloatRect& bounds)
+{
+    const auto [minX, minY] = Cell(bounds.position);
+    const auto [maxX, maxY] = Cell(bounds.position + bounds.size);
+    for (int y = minY; y <= maxY; ++y)
+    {
+        for (int x = minX; x <= maxX; ++x)
+        {
+            _cells[Key(x, y)].push_back({.id = id, .bounds = bounds});
+        }
+    }
+
+    _count++;
+}
+
+void SpatialHashGrid::Remove(const flecs::entity_t id, const sf::FloatRect& bounds)
+{
+    bool found = false;
+
+    const auto [minX, minY] = Cell(bounds.position);
+    const auto [maxX, maxY] = Cell(bounds.position + bounds.size);
+    for (int y = minY; y <= maxY; ++y)
+    {
+        for (int x = minX; x <= maxX; ++x)
+        {
+            const auto it = _cells.find(Key(x, y));
+            if (it == _cells.end())
+            {
+                continue;
+            }
+
+            // Order inside a cell doesn't matter, swap and pop
+            auto& entries = it->second;
+            const auto entry = std::ranges::find(entries, id, &Entry::id);
+            if (entry == entries.end())
+            {
+                continue;
+            }
+
+            *entry = entries.back();
+            entries.pop_back();
+            found = true;
+
+            if (entries.empty())
+            {
+                _cells.erase(it);
+            }
+        }
+    }
+
+    if (found)
+    {
+        _count--;
+    }
+}
+
+void SpatialHashGrid::Clear()
+{
+    _cells.clear();
+    _count = 0;
+}
+
+bool SpatialHashGrid::IsEmpty() const
+{
+    return _count == 0;
+}
+
+std::size_t SpatialHashGrid::Size() const
+{
+    return _count;
+}
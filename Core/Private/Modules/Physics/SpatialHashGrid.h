@@ -0,0 +1,94 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+
+#include <flecs.h>
+#include <unordered_map>
+#include <vector>
+
+#include <cmath>
+#include <cstdint>
+
+/**
+ * @brief Sparse uniform grid for the physics sets that rarely change (sleeping bodies, statics, triggers).
+ *
+ * An entry is stored in every cell its bounds overlap, so Query can report the same id more than once when the
+ * bounds span several cells. Querying an empty grid costs nothing, which is the whole point: sets that don't move are
+ * only ever looked at by the bodies that do.
+ */
+class SpatialHashGrid
+{
+public:
+    struct Entry
+    {
+        flecs::entity_t id = 0;
+        sf::FloatRect bounds;
+    };
+
+    SpatialHashGrid() = default;
+    explicit SpatialHashGrid(float cellSize);
+
+    void Insert(flecs::entity_t id, const sf::FloatRect& bounds);
+    void Remove(flecs::entity_t id, const sf::FloatRect& bounds);
+    void Clear();
+
+    [[nodiscard]] bool IsEmpty() const;
+    [[nodiscard]] std::size_t Size() const;
+
+    /**
+     * @brief Calls func(const Entry&) for every entry whose bounds intersect the given bounds.
+     */
+    template <typename Func>
+    void Query(const sf::FloatRect& bounds, Func&& func) const
+    {
+        if (_count == 0)
+        {
+            return;
+        }
+
+        const auto [minX, minY] = Cell(bounds.position);
+        const auto [maxX, maxY] = Cell(bounds.position + bounds.size);
+        for (int y = minY; y <= maxY; ++y)
+        {
+            for (int x = minX; x <= maxX; ++x)
+            {
+                const auto it = _cells.find(Key(x, y));
+                if (it == _cells.end())
+                {
+                    continue;
+                }
+
+                for (const Entry& entry : it->second)
+                {
+                    if (Overlaps(entry.bounds, bounds))
+                    {
+                        func(entry);
+                    }
+                }
+            }
+        }
+    }
+
+    static bool Overlaps(const sf::FloatRect& a, const sf::FloatRect& b)
+    {
+        return a.position.x <= b.position.x + b.size.x && b.position.x <= a.position.x + a.size.x &&
+               a.position.y <= b.position.y + b.size.y && b.position.y <= a.position.y + a.size.y;
+    }
+
+private:
+    [[nodiscard]] sf::Vector2i Cell(const sf::Vector2f& point) const
+    {
+        return {static_cast<int>(std::floor(point.x / _cellSize)), static_cast<int>(std::floor(point.y / _cellSize))};
+    }
+
+    static std::int64_t Key(const int x, const int y)
+    {
+        return (static_cast<std::int64_t>(x) << 32) | static_cast<std::uint32_t>(y);
+    }
+
+    float _cellSize = 64.f;
+    std::size_t _count = 0;
+    std::unordered_map<std::int64_t, std::vector<Entry>> _cells;
+};
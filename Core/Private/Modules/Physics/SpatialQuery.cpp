@@ -0,0 +1,369 @@
+// Copyright (c) Eric Jeker 2025.
+
+#include "SFE/Modules/Physics/Singletons/SpatialQuery.h"
+
+#include <tracy/Tracy.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+
+float Dot(const sf::Vector2f& a, const sf::Vector2f& b)
+{
+    return a.x * b.x + a.y * b.y;
+}
+
+sf::Vector2f ClosestPoint(const sf::FloatRect& box, const sf::Vector2f& point)
+{
+    return {std::clamp(point.x, box.position.x, box.position.x + box.size.x),
+            std::clamp(point.y, box.position.y, box.position.y + box.size.y)};
+}
+
+bool BoxContains(const sf::FloatRect& box, const sf::Vector2f& point)
+{
+    return point.x >= box.position.x && point.x <= box.position.x + box.size.x && point.y >= box.position.y &&
+           point.y <= box.position.y + box.size.y;
+}
+
+bool BoxesOverlap(const sf::FloatRect& a, const sf::FloatRect& b)
+{
+    return a.position.x <= b.position.x + b.size.x && b.position.x <= a.position.x + a.size.x &&
+           a.position.y <= b.position.y + b.size.y && b.position.y <= a.position.y + a.size.y;
+}
+
+/**
+ * @brief Distance along the normalized direction where the ray enters the circle, or a negative value on a miss.
+ */
+float RayCircle(const sf::Vector2f& origin, const sf::Vector2f& direction, const sf::Vector2f& center,
+                const float radius, sf::Vector2f& normal)
+{
+    const sf::Vector2f m = origin - center;
+    const float b = Dot(m, direction);
+    const float c = Dot(m, m) - radius * radius;
+    if (c <= 0.f)
+    {
+        // Starting inside the circle
+        normal = -direction;
+        return 0.f;
+    }
+
+    const float discriminant = b * b - c;
+    if (b > 0.f || discriminant < 0.f)
+    {
+        return -1.f;
+    }
+
+    const float distance = -b - std::sqrt(discriminant);
+    normal = (origin + direction * distance - center) / radius;
+    return distance;
+}
+
+/**
+ * @brief Distance along the normalized direction where the ray enters the box, or a negative value on a miss.
+ */
+float RayBox(const sf::Vector2f& origin, const sf::Vector2f& direction, const sf::FloatRect& box, sf::Vector2f& normal)
+{
+    if (BoxContains(box, origin))
+    {
+        normal = -direction;
+        return 0.f;
+    }
+
+    float tMin = 0.f;
+    float tMax = std::numeric_limits<float>::max();
+    sf::Vector2f entryNormal;
+
+    const auto slab = [&](const float start, const float delta, const float min, const float max, const sf::Vector2f& axis)
+    {
+        if (std::abs(delta) < 1e-8f)
+        {
+            return start >= min && start <= max;
+        }
+
+        float t1 = (min - start) / delta;
+        float t2 = (max - start) / delta;
+        sf::Vector2f axisNormal = -axis;
+        if (t1 > t2)
+        {
+            std::swap(t1, t2);
+            axisNormal = axis;
+        }
+
+        if (t1 > tMin)
+        {
+            tMin = t1;
+            entryNormal = axisNormal;
+        }
+        tMax = std::min(tMax, t2);
+        return tMin <= tMax;
+    };
+
+    if (!slab(origin.x, direction.x, box.position.x, box.position.x + box.size.x, {1.f, 0.f}) ||
+        !slab(origin.y, direction.y, box.position.y, box.position.y + box.size.y, {0.f, 1.f}))
+    {
+        return -1.f;
+    }
+
+    normal = entryNormal;
+    return tMin;
+}
+
+/**
+ * @brief Inserts the hit in the results sorted by distance, dropping the farthest one when the results are full.
+ */
+template <typename Hit>
+void InsertSorted(std::span<Hit> results, std::size_t& count, const Hit& hit)
+{
+    if (count == results.size() && hit.distance >= results[count - 1].distance)
+    {
+        return;
+    }
+
+    std::size_t index = std::min(count, results.size() - 1);
+    while (index > 0 && results[index - 1].distance > hit.distance)
+    {
+        if (index < results.size())
+        {
+            results[index] = results[index - 1];
+        }
+        --index;
+    }
+    results[index] = hit;
+    count = std::min(count + 1, results.size());
+}
+
+} // namespace
+
+SpatialQuery::SpatialQuery(const flecs::world_t* world)
+    : _world(world)
+{
+}
+
+std::size_t SpatialQuery::Raycast(const sf::Vector2f& origin, const sf::Vector2f& direction, const float maxDistance,
+                                  const std::span<RaycastHit> hits, const std::uint32_t mask) const
+{
+    ZoneScopedN("SpatialQuery::Raycast");
+
+    const float length = std::sqrt(Dot(direction, direction));
+    if (hits.empty() || length <= 0.f || maxDistance <= 0.f)
+    {
+        return 0;
+    }
+
+    const sf::Vector2f unit = direction / length;
+    std::size_t count = 0;
+
+    _tree.RayCast(origin, origin + unit * maxDistance, [&](const std::int32_t proxy, const float maxFraction) {
+        const Shape& shape = _shapes[proxy];
+        if ((shape.layer & mask) == 0)
+        {
+            return maxFraction;
+        }
+
+        sf::Vector2f normal;
+        const float distance = shape.IsCircle() ? RayCircle(origin, unit, shape.center, shape.radius, normal)
+                                                : RayBox(origin, unit, shape.box, normal);
+        if (distance < 0.f || distance > maxFraction * maxDistance)
+        {
+            return maxFraction;
+        }
+
+        InsertSorted(hits, count, {flecs::entity(_world, shape.entity), origin + unit * distance, normal, distance});
+
+        // Once the results are full, only the hits closer than the farthest one are interesting
+        return count == hits.size() ? hits[count - 1].distance / maxDistance : maxFraction;
+    });
+
+    return count;
+}
+
+std::size_t SpatialQuery::OverlapPoint(const sf::Vector2f& point, const std::span<flecs::entity> results,
+                                       const std::uint32_t mask) const
+{
+    ZoneScopedN("SpatialQuery::OverlapPoint");
+
+    std::size_t count = 0;
+    if (results.empty())
+    {
+        return count;
+    }
+
+    _tree.Query({point, {0.f, 0.f}}, [&](const std::int32_t proxy) {
+        const Shape& shape = _shapes[proxy];
+        if ((shape.layer & mask) == 0)
+        {
+            return true;
+        }
+
+        const sf::Vector2f delta = point - shape.center;
+        const bool hit = shape.IsCircle() ? Dot(delta, delta) <= shape.radius * shape.radius : BoxContains(shape.box, point);
+        if (hit)
+        {
+            results[count++] = flecs::entity(_world, shape.entity);
+        }
+        return count < results.size();
+    });
+
+    return count;
+}
+
+std::size_t SpatialQuery::OverlapBox(const sf::FloatRect& box, const std::span<flecs::entity> results,
+                                     const std::uint32_t mask) const
+{
+    ZoneScopedN("SpatialQuery::OverlapBox");
+
+    std::size_t count = 0;
+    if (results.empty())
+    {
+        return count;
+    }
+
+    _tree.Query(box, [&](const std::int32_t proxy) {
+        const Shape& shape = _shapes[proxy];
+        if ((shape.layer & mask) == 0)
+        {
+            return true;
+        }
+
+        bool hit;
+        if (shape.IsCircle())
+        {
+            const sf::Vector2f delta = shape.center - ClosestPoint(box, shape.center);
+            hit = Dot(delta, delta) <= shape.radius * shape.radius;
+        }
+        else
+        {
+            hit = BoxesOverlap(box, shape.box);
+        }
+
+        if (hit)
+        {
+            results[count++] = flecs::entity(_world, shape.entity);
+        }
+        return count < results.size();
+    });
+
+    return count;
+}
+
+std::size_t SpatialQuery::Nearest(const sf::Vector2f& point, const std::span<NearestHit> results,
+                                  const std::uint32_t mask) const
+{
+    ZoneScopedN("SpatialQuery::Nearest");
+
+    std::size_t count = 0;
+    if (results.empty())
+    {
+        return count;
+    }
+
+    _tree.QueryNearest(point, [&](const std::int32_t proxy) {
+        const Shape& shape = _shapes[proxy];
+        if ((shape.layer & mask) != 0)
+        {
+            float distance;
+            if (shape.IsCircle())
+            {
+                const sf::Vector2f delta = point - shape.center;
+                distance = std::max(0.f, std::sqrt(Dot(delta, delta)) - shape.radius);
+            }
+            else
+            {
+                const sf::Vector2f delta = point - ClosestPoint(shape.box, point);
+                distance = std::sqrt(Dot(delta, delta));
+            }
+
+            InsertSorted(results, count, {flecs::entity(_world, shape.entity), distance});
+        }
+
+        if (count < results.size())
+        {
+            return std::numeric_limits<float>::max();
+        }
+        return results[count - 1].distance * results[count - 1].distance;
+    });
+
+    return count;
+}
+
+void SpatialQuery::SetCircle(const flecs::entity_t entity, const sf::Vector2f& center, const float radius,
+                             const std::uint32_t layer)
+{
+    Set(entity, {.entity = entity, .layer = layer, .center = center, .radius = radius, .box = {}});
+}
+
+void SpatialQuery::SetBox(const flecs::entity_t entity, const sf::FloatRect& box, const std::uint32_t layer)
+{
+    Set(entity, {.entity = entity, .layer = layer, .center = box.position + box.size / 2.f, .radius = -1.f, .box = box});
+}
+
+void SpatialQuery::Move(const flecs::entity_t entity, const sf::Vector2f& position)
+{
+    const auto it = _proxies.find(entity);
+    if (it == _proxies.end())
+    {
+        return;
+    }
+
+    Shape& shape = _shapes[it->second];
+    const sf::Vector2f center = shape.IsCircle() ? position : position + shape.box.size / 2.f;
+    if (center == shape.center)
+    {
+        return;
+    }
+
+    const sf::Vector2f displacement = center - shape.center;
+    shape.center = center;
+    shape.box.position = position;
+    _tree.MoveProxy(it->second, shape.Bounds(), displacement);
+}
+
+void SpatialQuery::Remove(const flecs::entity_t entity)
+{
+    const auto it = _proxies.find(entity);
+    if (it == _proxies.end())
+    {
+        return;
+    }
+
+    _tree.DestroyProxy(it->second);
+    _proxies.erase(it);
+}
+
+std::size_t SpatialQuery::Size() const
+{
+    return _proxies.size();
+}
+
+const DynamicAABBTree& SpatialQuery::GetTree() const
+{
+    return _tree;
+}
+
+sf::FloatRect SpatialQuery::Shape::Bounds() const
+{
+    if (IsCircle())
+    {
+        return {center - sf::Vector2f(radius, radius), sf::Vector2f(radius, radius) * 2.f};
+    }
+    return box;
+}
+
+void SpatialQuery::Set(const flecs::entity_t entity, const Shape& shape)
+{
+    const auto [it, inserted] = _proxies.try_emplace(entity, DynamicAABBTree::NULL_NODE);
+    if (inserted)
+    {
+        it->second = _tree.CreateProxy(shape.Bounds(), entity);
+        _shapes.resize(_tree.GetNodeCapacity());
+    }
+    else
+    {
+        _tree.MoveProxy(it->second, shape.Bounds(), shape.center - _shapes[it->second].center);
+    }
+
+    _shapes[it->second] = shape;
+}
@@ -0,0 +1,78 @@
+// Copyright (c) Eric Jeker 2025.
+
+#include "Modules/Physics/StaticBVH.h"
+
+#include <tracy/Tracy.hpp>
+
+#include <algorithm>
+
+void StaticBVH::Build(std::vector<StaticShape>&& shapes)
+{
+    ZoneScopedN("StaticBVH::Build");
+
+    _shapes = std::move(shapes);
+    _nodes.clear();
+    if (_shapes.empty())
+    {
+        return;
+    }
+
+    _nodes.reserve(2 * (_shapes.size() / LEAF_SIZE + 1));
+    BuildNode(0, static_cast<std::uint32_t>(_shapes.size()));
+}
+
+bool StaticBVH::IsEmpty() const
+{
+    return _shapes.empty();
+}
+
+std::size_t StaticBVH::Size() const
+{
+    return _shapes.size();
+}
+
+void StaticBVH::BuildNode(const std::uint32_t begin, const std::uint32_t end)
+{
+    const auto index = static_cast<std::uint32_t>(_nodes.size());
+    _nodes.emplace_back();
+
+    // Bounds of the shapes and of their centers, the centers decide the split
+    sf::Vector2f min = _shapes[begin].bounds.position;
+    sf::Vector2f max = min + _shapes[begin].bounds.size;
+    sf::Vector2f centerMin = _shapes[begin].center;
+    sf::Vector2f centerMax = centerMin;
+    for (std::uint32_t i = begin; i < end; ++i)
+    {
+        const sf::FloatRect& bounds = _shapes[i].bounds;
+        min = {std::min(min.x, bounds.position.x), std::min(min.y, bounds.position.y)};
+        max = {std::max(max.x, bounds.position.x + bounds.size.x), std::max(max.y, bounds.position.y + bounds.size.y)};
+
+        const sf::Vector2f& center = _shapes[i].center;
+        centerMin = {std::min(centerMin.x, center.x), std::min(centerMin.y, center.y)};
+        centerMax = {std::max(centerMax.x, center.x), std::max(centerMax.y, center.y)};
+    }
+    _nodes[index].bounds = {min, max - min};
+
+    if (end - begin <= LEAF_SIZE)
+    {
+        _nodes[index].first = begin;
+        _nodes[index].count = end - begin;
+        return;
+    }
+
+    // Median split along the longest axis of the centers
+    const bool splitX = centerMax.x - centerMin.x >= centerMax.y - centerMin.y;
+    const std::uint32_t middle = begin + (end - begin) / 2;
+    std::nth_element(
+        _shapes.begin() + begin, _shapes.begin() + middle, _shapes.begin() + end,
+        [splitX](const StaticShape& a, const StaticShape& b) {
+            return splitX ? a.center.x < b.center.x : a.center.y < b.center.y;
+        }
+    );
+
+    // The left child is the next node, _nodes can grow so the index is written after the recursion
+    BuildNode(begin, middle);
+    const auto right = static_cast<std::uint32_t>(_nodes.size());
+    BuildNode(middle, end);
+    _nodes[index].first = right;
+}
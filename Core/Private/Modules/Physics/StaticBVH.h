@@ -0,0 +1,109 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include "SFE/Modules/Physics/Components/CollisionFilter.h"
+
+#include <SFML/Graphics/Rect.hpp>
+
+#include <flecs.h>
+#include <array>
+#include <vector>
+
+#include <cassert>
+#include <cstdint>
+
+struct StaticShape
+{
+    flecs::entity_t entity = 0;
+    sf::FloatRect bounds;
+    // Circles are centered on the position, boxes have a negative radius and use the bounds
+    sf::Vector2f center;
+    float radius = -1.f;
+    CollisionFilter filter;
+
+    [[nodiscard]] bool IsCircle() const
+    {
+        return radius >= 0.f;
+    }
+};
+
+/**
+ * @brief Immutable bounding volume hierarchy over the static colliders, built top-down in one go.
+ *
+ * Nodes are stored depth-first in a flat array: the left child of an internal node is the next node, so the traversal
+ * mostly walks forward in memory. There is no update, the whole hierarchy is rebuilt when the set of statics changes.
+ */
+class StaticBVH
+{
+public:
+    void Build(std::vector<StaticShape>&& shapes);
+
+    [[nodiscard]] bool IsEmpty() const;
+    [[nodiscard]] std::size_t Size() const;
+
+    /**
+     * @brief Calls func(const StaticShape&) for every shape whose bounds intersect the given bounds, once per shape.
+     */
+    template <typename Func>
+    void Query(const sf::FloatRect& bounds, Func&& func) const
+    {
+        if (_nodes.empty())
+        {
+            return;
+        }
+
+        std::array<std::uint32_t, STACK_CAPACITY> stack;
+        std::size_t count = 0;
+        stack[count++] = 0;
+
+        while (count > 0)
+        {
+            const std::uint32_t index = stack[--count];
+            const Node& node = _nodes[index];
+            if (!Overlaps(node.bounds, bounds))
+            {
+                continue;
+            }
+
+            if (node.count > 0)
+            {
+                for (std::uint32_t i = node.first; i < node.first + node.count; ++i)
+                {
+                    if (Overlaps(_shapes[i].bounds, bounds))
+                    {
+                        func(_shapes[i]);
+                    }
+                }
+                continue;
+            }
+
+            assert(count + 2 <= STACK_CAPACITY && "StaticBVH traversal stack overflow");
+            stack[count++] = node.first;
+            stack[count++] = index + 1;
+        }
+    }
+
+private:
+    static constexpr std::uint32_t LEAF_SIZE = 4;
+    static constexpr std::size_t STACK_CAPACITY = 128;
+
+    struct Node
+    {
+        sf::FloatRect bounds;
+        // Leaves: first shape and shape count. Internal nodes: right child and a count of 0
+        std::uint32_t first = 0;
+        std::uint32_t count = 0;
+    };
+
+    static bool Overlaps(const sf::FloatRect& a, const sf::FloatRect& b)
+    {
+        return a.position.x <= b.position.x + b.size.x && b.position.x <= a.position.x + a.size.x &&
+               a.position.y <= b.position.y + b.size.y && b.position.y <= a.position.y + a.size.y;
+    }
+
+    void BuildNode(std::uint32_t begin, std::uint32_t end);
+
+    std::vector<Node> _nodes;
+    std::vector<StaticShape> _shapes;
+};
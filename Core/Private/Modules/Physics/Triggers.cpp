@@ -0,0 +1,168 @@
+// Copyright (c) Eric Jeker 2025.
+
+#include "Modules/Physics/Triggers.h"
+
+#include "SFE/Modules/Physics/Components/CollisionFilter.h"
+#include "SFE/Modules/Physics/Components/TriggerEvents.h"
+#include "SFE/Modules/Physics/Components/Velocity.h"
+#include "SFE/Modules/Physics/Singletons/ActiveTriggers.h"
+#include "SFE/Utils/Collision.h"
+
+#include <algorithm>
+#include <tracy/Tracy.hpp>
+
+namespace
+{
+
+enum class TriggerEventType
+{
+    Entered,
+    Stayed,
+    Exited
+};
+
+void AddEvent(
+    const flecs::world& world,
+    std::vector<flecs::entity>& active,
+    const TriggerPair& pair,
+    const TriggerEventType type
+)
+{
+    const auto& [triggerId, bodyId] = pair;
+    if (!world.is_alive(triggerId) || !world.is_alive(bodyId))
+    {
+        return;
+    }
+
+    const flecs::entity trigger = world.entity(triggerId);
+    auto& [entered, stayed, exited] = trigger.get_mut<TriggerEvents>();
+
+    // The events were cleared at the start of the step, the first one makes the trigger active
+    if (entered.empty() && stayed.empty() && exited.empty())
+    {
+        active.push_back(trigger);
+    }
+
+    switch (type)
+    {
+        case TriggerEventType::Entered:
+            entered.push_back(world.entity(bodyId));
+            break;
+        case TriggerEventType::Stayed:
+            stayed.push_back(world.entity(bodyId));
+            break;
+        case TriggerEventType::Exited:
+            exited.push_back(world.entity(bodyId));
+            break;
+    }
+}
+
+} // namespace
+
+namespace Triggers
+{
+
+void Register(PhysicsState& state, const flecs::entity_t trigger, const sf::FloatRect& bounds)
+{
+    Unregister(state, trigger);
+
+    state.triggerGrid.Insert(trigger, bounds);
+    state.triggerBounds.emplace(trigger, bounds);
+}
+
+void Unregister(PhysicsState& state, const flecs::entity_t trigger)
+{
+    const auto it = state.triggerBounds.find(trigger);
+    if (it == state.triggerBounds.end())
+    {
+        return;
+    }
+
+    state.triggerGrid.Remove(trigger, it->second);
+    state.triggerBounds.erase(it);
+}
+
+int Update(const flecs::world& world, PhysicsState& state)
+{
+    ZoneScopedN("PhysicsModule::Triggers");
+
+    // Consume the events of the last step, only the triggers that had some are touched
+    auto& active = world.get_mut<ActiveTriggers>().triggers;
+    for (const flecs::entity trigger : active)
+    {
+        if (trigger.is_alive())
+        {
+            auto& [entered, stayed, exited] = trigger.get_mut<TriggerEvents>();
+            entered.clear();
+            stayed.clear();
+            exited.clear();
+        }
+    }
+    active.clear();
+
+    // Nothing moves near a trigger and nothing was inside one, there is nothing to do
+    auto& previous = state.triggerPairs;
+    if (previous.empty() && (state.triggerGrid.IsEmpty() || state.bodies.empty()))
+    {
+        return 0;
+    }
+
+    auto& current = state.currentTriggerPairs;
+    current.clear();
+
+    for (const PhysicsBody& body : state.bodies)
+    {
+        const sf::Vector2f center = body.transform->position;
+        state.triggerGrid.Query(CircleBounds(center, body.radius), [&](const SpatialHashGrid::Entry& entry) {
+            if (!Collision::CheckAABBCircleCollision(entry.bounds, center, body.radius).hasCollision)
+            {
+                return;
+            }
+
+            const auto* filter = world.entity(entry.id).try_get<CollisionFilter>();
+            if (filter == nullptr || CanCollide(*filter, body.filter))
+            {
+                current.emplace_back(entry.id, body.entity.id());
+            }
+        });
+    }
+
+    // Sleeping bodies don't move, whatever they were overlapping they still do
+    for (const auto& [trigger, body] : previous)
+    {
+        if (state.triggerBounds.contains(trigger) && world.is_alive(body) && !world.entity(body).enabled<Velocity>())
+        {
+            current.emplace_back(trigger, body);
+        }
+    }
+
+    // A trigger spanning several cells is reported once per cell
+    std::ranges::sort(current);
+    const auto duplicates = std::ranges::unique(current);
+    current.erase(duplicates.begin(), duplicates.end());
+
+    // Both sets are sorted, walk them together
+    auto previousIt = previous.begin();
+    auto currentIt = current.begin();
+    while (previousIt != previous.end() || currentIt != current.end())
+    {
+        if (currentIt == current.end() || (previousIt != previous.end() && *previousIt < *currentIt))
+        {
+            AddEvent(world, active, *previousIt++, TriggerEventType::Exited);
+        }
+        else if (previousIt == previous.end() || *currentIt < *previousIt)
+        {
+            AddEvent(world, active, *currentIt++, TriggerEventType::Entered);
+        }
+        else
+        {
+            AddEvent(world, active, *currentIt++, TriggerEventType::Stayed);
+            ++previousIt;
+        }
+    }
+
+    std::swap(previous, current);
+    return static_cast<int>(previous.size());
+}
+
+} // namespace Triggers
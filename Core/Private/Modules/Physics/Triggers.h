@@ -0,0 +1,27 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include "Modules/Physics/PhysicsState.h"
+
+#include <SFML/Graphics/Rect.hpp>
+
+#include <flecs.h>
+
+/**
+ * Trigger volumes: the static triggers live in a spatial grid that only the awake bodies query, and the overlapping
+ * (trigger, body) pairs are diffed with the previous step to produce the enter, stay and exit events.
+ */
+namespace Triggers
+{
+
+void Register(PhysicsState& state, flecs::entity_t trigger, const sf::FloatRect& bounds);
+void Unregister(PhysicsState& state, flecs::entity_t trigger);
+
+/**
+ * @brief Diffs the trigger pairs of the awake bodies gathered in the state with the previous step.
+ * @return the number of (trigger, body) pairs currently overlapping
+ */
+int Update(const flecs::world& world, PhysicsState& state);
+
+} // namespace Triggers
@@ -0,0 +1,17 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include <SFML/Graphics/Vertex.hpp>
+
+#include <vector>
+
+/**
+ * @brief Vertices of the particles drawn this frame, a singleton of each world kept between frames so they are not
+ * reallocated every frame.
+ */
+struct ParticleVertices
+{
+    std::vector<sf::Vertex> points;
+    std::vector<sf::Vertex> quads;
+};
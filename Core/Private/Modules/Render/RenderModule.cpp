@@ -2,9 +2,13 @@
 
 #include "SFE/Modules/Render/RenderModule.h"
 
+#include "Modules/Render/ParticleVertices.h"
+
 #include "SFE/GameService.h"
 
 #include "SFE/Modules/Particles/Components/Particle.h"
+#include "SFE/Modules/Particles/Components/ParticleEmitter.h"
+#include "SFE/Modules/Particles/Singletons/ParticleBudget.h"
 #include "SFE/Modules/Render/Components/CircleRenderable.h"
 #include "SFE/Modules/Render/Components/RectangleRenderable.h"
 #include "SFE/Modules/Render/Components/ShaderUniform.h"
@@ -13,6 +17,7 @@
 #include "SFE/Modules/Render/Components/TextRenderable.h"
 #include "SFE/Modules/Render/Components/Transform.h"
 #include "SFE/Modules/Render/Components/ZOrder.h"
+#include "SFE/Modules/Window/Singletons/Headless.h"
 
 #include <SFML/Graphics/RenderWindow.hpp>
 
@@ -147,28 +152,66 @@ void RenderAllParticles(const flecs::iter& it)
 {
     ZoneScopedN("RenderModule::RenderAllParticles");
 
+    if (it.world().has<Headless>())
+    {
+        return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    auto& vertices = it.world().get_mut<ParticleVertices>();
+    auto& points = vertices.points;
+    auto& quads = vertices.quads;
+    points.clear();
+    quads.clear();
+
+    // Particles of one pixel are points, the bigger ones two triangles
+    const auto addParticle = [&](const sf::Vector2f& position, const sf::Color& color, const float size) {
+        if (size <= 1.f)
+        {
+            points.push_back({.position = position, .color = color});
+            return;
+        }
+
+        const float half = size * 0.5f;
+        const sf::Vertex topLeft = {.position = position + sf::Vector2f{-half, -half}, .color = color};
+        const sf::Vertex topRight = {.position = position + sf::Vector2f{half, -half}, .color = color};
+        const sf::Vertex bottomRight = {.position = position + sf::Vector2f{half, half}, .color = color};
+        const sf::Vertex bottomLeft = {.position = position + sf::Vector2f{-half, half}, .color = color};
+        quads.insert(quads.end(), {topLeft, topRight, bottomRight, topLeft, bottomRight, bottomLeft});
+    };
+
     // Collect all particle positions in one pass
-    std::vector<sf::Vector2f> particlePositions;
     it.world().each([&](const flecs::entity e, const Transform& t, const Particle& p) {
         // TODO: Frustum culling, test if particle is visible
-        particlePositions.push_back(t.position);
+        addParticle(t.position, p.color, p.size);
     });
 
-    if (particlePositions.empty())
-        return;
-
-    // Create one big vertex array for ALL particles
-    sf::VertexArray vertices{sf::PrimitiveType::Points, particlePositions.size()};
+    // The buffered particles are copied straight from the arrays of their emitter
+    it.world().each([&](const ParticleEmitter& emitter) {
+        const auto& particles = emitter.particles;
+        for (std::size_t i = 0; i < particles.Size(); ++i)
+        {
+            addParticle(particles.positions[i], particles.colors[i], particles.sizes[i]);
+        }
+    });
 
-    for (size_t i = 0; i < particlePositions.size(); ++i)
+    // One draw call per primitive type for ALL particles!
+    auto& window = GameService::Get<sf::RenderWindow>();
+    if (!points.empty())
     {
-        vertices[i].position = particlePositions[i];
-        vertices[i].color = sf::Color::White;
+        window.draw(points.data(), points.size(), sf::PrimitiveType::Points);
+    }
+    if (!quads.empty())
+    {
+        window.draw(quads.data(), quads.size(), sf::PrimitiveType::Triangles);
     }
 
-    // Single draw call for ALL particles!
-    auto& window = GameService::Get<sf::RenderWindow>();
-    window.draw(vertices);
+    // The particle budget throttles the emitters on the update and render time of the particles
+    if (auto* budget = it.world().try_get_mut<ParticleBudget>(); budget != nullptr)
+    {
+        budget->renderTime += std::chrono::steady_clock::now() - start;
+    }
 }
 
 struct RenderableEntry
@@ -181,6 +224,12 @@ void Render(const flecs::iter& it)
 {
     ZoneScopedN("RenderModule::Render");
 
+    // Nothing to draw on without a window
+    if (it.world().has<Headless>())
+    {
+        return;
+    }
+
     // TODO: Reserve vector
     std::vector<RenderableEntry> renderables;
 
@@ -265,6 +314,9 @@ RenderModule::RenderModule(const flecs::world& world)
     world.component<SpriteRenderable>();
     world.component<TextRenderable>();
     world.component<ZOrder>();
+    world.component<ParticleVertices>();
+
+    world.set<ParticleVertices>({});
 
     // --- We apply all the Transform to the Renderables ---
     world.system<const Transform, CircleRenderable>("RenderModule::ApplyTransformToCircle").kind(flecs::PreStore).each(ApplyTransformToCircle);
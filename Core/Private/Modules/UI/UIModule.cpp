@@ -4,8 +4,14 @@
 
 #include "SFE/GameService.h"
 
+#include "SFE/Modules/Camera/Singletons/MainCamera.h"
 #include "SFE/Modules/Window/Components/Event.h"
+#include "SFE/Modules/Window/Singletons/Headless.h"
+#include "SFE/Modules/Window/Singletons/WindowSize.h"
 #include "SFE/Modules/Lifetime/Components/LifetimeOneFrame.h"
+#include "SFE/Modules/Physics/Components/CollisionFilter.h"
+#include "SFE/Modules/Physics/Singletons/SpatialQuery.h"
+#include "SFE/Modules/Render/Components/Radius.h"
 #include "SFE/Modules/Render/Components/Size.h"
 #include "SFE/Modules/Render/Components/TextRenderable.h"
 #include "SFE/Modules/Render/Components/Transform.h"
@@ -29,11 +35,102 @@
 #include "SFE/Modules/UI/Prefabs/MousePressedEvent.h"
 #include "SFE/Modules/UI/Prefabs/MouseReleasedEvent.h"
 
+#include <array>
+#include <cmath>
+#include <optional>
+#include <span>
+
+namespace
+{
+
+/**
+ * Puts the clickable entity on the UI layer and indexes it, its Transform and Size may have been added without a set.
+ */
+void IndexClickable(const flecs::entity e, const Clickable&)
+{
+    // Without a filter of its own the entity stays off the physics layers
+    const auto* filter = e.try_get<CollisionFilter>();
+    CollisionFilter uiFilter = {.layer = CollisionLayer::None, .mask = CollisionLayer::None};
+    if (filter != nullptr)
+    {
+        uiFilter = *filter;
+    }
+    if ((uiFilter.layer & CollisionLayer::UI) == 0)
+    {
+        uiFilter.layer |= CollisionLayer::UI;
+        e.set<CollisionFilter>(uiFilter);
+    }
+
+    auto* spatialQuery = e.world().try_get_mut<SpatialQuery>();
+    const auto* t = e.try_get<Transform>();
+    const auto* s = e.try_get<Size>();
+    if (spatialQuery != nullptr && t != nullptr && s != nullptr && !e.has<Radius>())
+    {
+        spatialQuery->SetBox(e.id(), {t->position, s->size}, uiFilter.layer);
+    }
+}
+
+/**
+ * Maps the pixel to world coordinates. A headless run has no window, the MainCamera view and the WindowSize stand in
+ * for it, with the math of sf::RenderTarget::mapPixelToCoords.
+ */
+std::optional<sf::Vector2f> MapPixelToWorld(const flecs::world& world, const sf::Vector2i& pixel)
+{
+    if (!world.has<Headless>())
+    {
+        const auto& window = GameService::Get<sf::RenderWindow>();
+        return window.mapPixelToCoords(pixel, window.getView());
+    }
+
+    const auto* camera = world.try_get<MainCamera>();
+    const auto* windowSize = world.try_get<WindowSize>();
+    if (camera == nullptr || windowSize == nullptr)
+    {
+        return std::nullopt;
+    }
+
+    // The viewport in pixels, rounded as the window does
+    const sf::Vector2f size(windowSize->currentSize);
+    const sf::FloatRect ratio = camera->view.getViewport();
+    const sf::Vector2f position = ratio.position.componentWiseMul(size);
+    const sf::Vector2f extent = ratio.size.componentWiseMul(size);
+    const sf::Vector2f origin = {std::round(position.x), std::round(position.y)};
+    const sf::Vector2f viewport = {std::round(extent.x), std::round(extent.y)};
+
+    const sf::Vector2f relative = (sf::Vector2f(pixel) - origin).componentWiseDiv(viewport);
+    const sf::Vector2f normalized = sf::Vector2f(-1.f, 1.f) + sf::Vector2f(2.f, -2.f).componentWiseMul(relative);
+    return camera->view.getInverseTransform().transformPoint(normalized);
+}
+
+/**
+ * Calls the Event of the clickable entity when the point is within its bounds.
+ */
+void ClickIfHit(const flecs::entity e, const Event& eventTrigger, const Transform& t, const Size& s,
+                const sf::Vector2f& point)
+{
+    if (sf::FloatRect(t.position, s.size).contains(point))
+    {
+        // The mouse press hit this clickable entity
+        eventTrigger.callback(e.world());
+    }
+}
+
+} // namespace
+
 namespace Core::Modules
 {
 
 UIModule::UIModule(const flecs::world& world)
 {
+    // --- Declare Events ---
+    // The event entities are pooled, a released one is hidden by toggling its event off
+    world.component<MousePressed>().add(flecs::CanToggle);
+    world.component<MouseReleased>().add(flecs::CanToggle);
+    world.component<KeyPressed>().add(flecs::CanToggle);
+    world.component<KeyReleased>().add(flecs::CanToggle);
+    world.component<FocusLost>().add(flecs::CanToggle);
+    world.component<FocusGained>().add(flecs::CanToggle);
+
     // --- Declare Prefabs ---
     world.prefab<Prefabs::MousePressedEvent>().add<LifetimeOneFrame>().add<MousePressed>();
     world.prefab<Prefabs::MouseReleasedEvent>().add<LifetimeOneFrame>().add<MouseReleased>();
@@ -57,41 +154,67 @@ UIModule::UIModule(const flecs::world& world)
 
     // Update the mouse position every frame
     world.system("UIInputSystem").write<MousePosition>().kind(flecs::PostLoad).run([](const flecs::iter& it) {
+        // The mouse of the machine has nothing to do with a headless run
+        if (it.world().has<Headless>())
+        {
+            return;
+        }
+
         const auto& renderWindow = GameService::Get<sf::RenderWindow>();
         const auto pos = sf::Mouse::getPosition(renderWindow);
         it.world().set<MousePosition>({.position = pos});
     });
 
+    world.observer<const Clickable>("UIIndexClickable").event(flecs::OnSet).each(IndexClickable);
+
     // Handle mouse-released events and hit test on all the UI components
+    const auto clickables = world.query<const Clickable, const Event, const Transform, const Size>();
     world.system<const MouseReleased>("UIHitTest")
         // The UIHitTest need to be immediate to merge the world state so the intents are process within the same frame
         .immediate()
         .kind(flecs::PostLoad)
-        .each([](const flecs::iter& it, size_t index, const MouseReleased& mouseReleased) {
+        .each([clickables](const flecs::iter& it, size_t index, const MouseReleased& mouseReleased) {
             // We have a mouseReleased event. Now, find any clickable entities that were hit.
             if (mouseReleased.button != sf::Mouse::Button::Left)
             {
                 return;
             }
 
-            // Query the world for all entities that are Clickable and have the necessary components
-            it.world().query<const Clickable, const Event, const Transform, const Size>().each(
-                [&mouseReleased](const flecs::entity& e, const Clickable& clickable, const Event& eventTrigger, const Transform& t, const Size& s) {
-                    sf::FloatRect bounds;
-                    bounds.size = s.size;
-                    bounds.position = t.position;
-
-                    // Map the mouse position to world coordinates
-                    const auto& window = GameService::Get<sf::RenderWindow>();
-                    const auto worldPosition = window.mapPixelToCoords(mouseReleased.position, window.getView());
-
-                    if (bounds.contains(sf::Vector2f(worldPosition)))
-                    {
-                        // The mouse press hit this clickable entity
-                        eventTrigger.callback(e.world());
-                    }
+            // Map the mouse position to world coordinates
+            const std::optional<sf::Vector2f> mapped = MapPixelToWorld(it.world(), mouseReleased.position);
+            if (!mapped)
+            {
+                return;
+            }
+            const sf::Vector2f worldPosition = *mapped;
+
+            // Without the PhysicsModule there is no spatial index, every clickable entity is tested
+            const auto* spatialQuery = it.world().try_get<SpatialQuery>();
+            if (spatialQuery == nullptr)
+            {
+                clickables.each([&worldPosition](const flecs::entity& e, const Clickable&, const Event& eventTrigger,
+                                                 const Transform& t, const Size& s) {
+                    ClickIfHit(e, eventTrigger, t, s, worldPosition);
+                });
+                return;
+            }
+
+            // Only the UI layer, so the hits can't be taken by the bodies under the mouse
+            std::array<flecs::entity, 16> hits;
+            const std::size_t count = spatialQuery->OverlapPoint(worldPosition, hits, CollisionLayer::UI);
+            for (const flecs::entity& e : std::span(hits).first(count))
+            {
+                const auto* eventTrigger = e.try_get<Event>();
+                const auto* t = e.try_get<Transform>();
+                const auto* s = e.try_get<Size>();
+                if (!e.has<Clickable>() || eventTrigger == nullptr || t == nullptr || s == nullptr)
+                {
+                    continue;
                 }
-            );
+
+                // Tested again on the current bounds, the index may be a step behind
+                ClickIfHit(e, *eventTrigger, *t, *s, worldPosition);
+            }
         });
 }
 
@@ -2,10 +2,15 @@
 
 #pragma once
 
+#include "SFE/Modules/Input/InputRecording.h"
+
 #include <SFML/Graphics/RenderWindow.hpp>
 
 #include <flecs.h>
 
+#include <filesystem>
+#include <memory>
+
 
 class GameInstance
 {
@@ -22,11 +27,31 @@ public:
      */
     void Run(sf::RenderWindow& renderWindow);
 
+    /**
+     * @brief Runs the replay started with StartReplay without any window, for soak and performance runs.
+     *
+     * The Headless singleton is added for the run: the Render, Camera and UI systems skip their window work, and the UI
+     * hit test maps the clicks through the MainCamera and the WindowSize instead. No sf::RenderWindow service is needed.
+     */
+    void RunHeadless();
+
+    /**
+     * @brief Records the input and the delta time of every frame that Run goes through to the file, see InputRecorder.
+     */
+    bool StartRecording(const std::filesystem::path& path);
+
+    /**
+     * @brief Takes the input from a recording instead of the window, each frame advances by the delta time it was
+     * recorded with and the run stops when the recording ends.
+     */
+    bool StartReplay(const std::filesystem::path& path);
+
     /**
      * @brief Translate the SFML events to Flecs entities
      * @param renderWindow
      */
     void HandleEvents(sf::RenderWindow& renderWindow) const;
+    void HandleEvent(const sf::Event& event) const;
     static void RunDeferredEvents(flecs::world& world);
 
     void RequestExit();
@@ -37,7 +62,11 @@ public:
     [[nodiscard]] const flecs::world& GetWorld() const;
 
 private:
+    void ReplayEvents() const;
+
     bool _shouldExit = false;
+    std::unique_ptr<InputRecorder> _recorder;
+    std::unique_ptr<InputReplay> _replay;
 
     // The Only World
     flecs::world _world;
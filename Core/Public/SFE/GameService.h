@@ -124,6 +124,15 @@ void Register(T& service)
     GetServices()[typeIndex] = std::make_unique<ServiceWrapper<T>>(service);
 }
 
+/**
+ * @brief Whether a service of the type is registered.
+ */
+template <typename T>
+bool Has()
+{
+    return GetServices().contains(std::type_index(typeid(T)));
+}
+
 /**
  * @brief Retrieves a registered service.
  * @tparam T The type of service to retrieve.
@@ -2,104 +2,422 @@
 
 #pragma once
 
-#include "SFE/Utils/Logger.h"
-
+#include <cassert>
+#include <cstdint>
 #include <functional>
-#include <map>
-#include <string>
-#include <typeindex>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
 template <typename T>
 using EventListener = std::function<void(const T& event, void* sender)>;
 
+/**
+ * @brief Listener receiving every deferred event of its type queued since the last flush, in one call.
+ */
+template <typename T>
+using EventBatchListener = std::function<void(std::span<const T> events)>;
+
+/**
+ * @brief Handle returned by EventManager::Subscribe, used to remove the listener again.
+ *
+ * The generation makes a stale handle harmless: once its slot is reused by another listener, unsubscribing it does
+ * nothing.
+ */
+struct EventSubscription
+{
+    static constexpr std::uint32_t INVALID = std::numeric_limits<std::uint32_t>::max();
+
+    std::uint32_t type = INVALID;
+    std::uint32_t slot = INVALID;
+    std::uint32_t generation = 0;
+    bool batch = false;
+
+    [[nodiscard]] bool IsValid() const
+    {
+        return type != INVALID;
+    }
+};
+
 /**
  * @brief PubSub system, where event can be processes immediately or deferred.
+ *
+ * Every event type gets a dense id the first time it is used, which indexes a flat table of listener slots. Emitting
+ * is an array access and a walk over the slots, without any allocation or lookup.
+ *
+ * High-volume events, like damage ticks or collisions, should be queued with EmitDeferred and consumed by a batch
+ * listener, which gets the whole buffer of the frame as a span when ProcessDeferredEvents flushes it.
+ *
+ * EmitDeferred can be called from any thread. Other threads than the one that created the manager queue into their
+ * own buffers, merged at ProcessDeferredEvents, which must run at a sync point where no worker is emitting.
  */
 class EventManager
 {
 public:
-    EventManager() = default;
+    EventManager();
     ~EventManager() = default;
+    EventManager(EventManager&&) = default;
+    EventManager& operator=(EventManager&&) = default;
 
     using TypeErasedListener = std::function<void(const void* eventData, void* sender)>;
-    using TypeErasedEvent = std::function<void(void* sender)>;
+    using TypeErasedBatchListener = std::function<void(const void* events, std::size_t count)>;
 
-    // Structure to hold deferred event information
-    struct DeferredEvent
+    /**
+     * @brief Dense id of the event type T, assigned on first use and stable for the lifetime of the program.
+     */
+    template <typename T>
+    static std::uint32_t TypeId()
     {
-        std::type_index eventType;
-        std::function<void()> eventExecutor;
-
-        DeferredEvent(std::type_index type, std::function<void()> executor)
-            : eventType(type)
-            , eventExecutor(std::move(executor))
-        {
-        }
-    };
+        static const std::uint32_t id = NextTypeId();
+        return id;
+    }
 
+    /**
+     * @brief Subscribes to the events of type T. A listener added while T is being emitted gets the events from the
+     * next emit on.
+     */
     template <typename T>
-    void Subscribe(EventListener<T> listener)
+    EventSubscription Subscribe(EventListener<T> listener)
     {
-        const std::type_index typeIndex(typeid(T));
-        auto wrapper = [listener](const void* eventData, void* sender)
+        auto wrapper = [listener = std::move(listener)](const void* eventData, void* sender)
         {
             const T* typedEvent = static_cast<const T*>(eventData);
             listener(*typedEvent, sender);
         };
-        _listeners[typeIndex].push_back(wrapper);
+        return AddListener(_listeners, TypeId<T>(), TypeErasedListener(std::move(wrapper)));
+    }
+
+    /**
+     * @brief Subscribes to the deferred events of type T, delivered all at once by ProcessDeferredEvents.
+     */
+    template <typename T>
+    EventSubscription SubscribeBatch(EventBatchListener<T> listener)
+    {
+        auto wrapper = [listener = std::move(listener)](const void* events, const std::size_t count)
+        {
+            listener(std::span<const T>(static_cast<const T*>(events), count));
+        };
+        return AddListener(_batchListeners, TypeId<T>(), TypeErasedBatchListener(std::move(wrapper)));
     }
 
+    /**
+     * @brief Removes the listener in constant time, the handle is reset. Safe to call from inside a listener.
+     */
+    void Unsubscribe(EventSubscription& subscription);
+
     template <typename T>
-    void Unsubscribe(EventListener<T> listener)
+    void Emit(const T& event, void* sender)
     {
-        const std::type_index typeIndex(typeid(T));
+        Dispatch(_listeners, TypeId<T>(), [&](const TypeErasedListener& listener) { listener(&event, sender); });
+    }
 
-        if (!_listeners.contains(typeIndex))
+    /**
+     * @brief Queues a copy of the event until the next ProcessDeferredEvents.
+     *
+     * Events are stored by value in a buffer per type, which keeps its capacity between frames, so queuing does not
+     * allocate once the buffers have grown to the usual load. A worker thread writes to its own buffers without any
+     * lock or atomic once it has emitted its first event.
+     */
+    template <typename T>
+    void EmitDeferred(const T& event, void* sender)
+    {
+        if (std::this_thread::get_id() == _ownerThread)
         {
-            return;
+            QueueDeferred(_deferred, event, sender);
+        }
+        else
+        {
+            QueueDeferred(GetProducerBuffers(), event, sender);
         }
-
-        _listeners[typeIndex]
-            .erase(std::remove(std::begin(_listeners[typeIndex]), std::end(_listeners[typeIndex]), listener), std::end(_listeners[typeIndex]));
     }
 
+    /**
+     * @brief Emits the queued events type by type, in the order their type was first queued, and each type in the
+     * order its events were queued. The listeners get the events one by one, then the batch listeners get them all.
+     * Events queued by the listeners go out at the latest on the next call.
+     *
+     * The events of the worker threads are appended after the ones of the owner thread, producer by producer in the
+     * order they first emitted, so the events of one producer keep their order.
+     */
+    void ProcessDeferredEvents();
+private:
+    template <typename Listener>
+    struct ListenerSlot
+    {
+        Listener listener;
+        std::uint32_t generation = 0;
+        bool active = false;
+    };
+
+    template <typename Listener>
+    struct ListenerTable
+    {
+        std::vector<ListenerSlot<Listener>> slots;
+        std::vector<std::uint32_t> freeSlots;
+        // Slots unsubscribed while emitting, their listener is destroyed once the emit returns
+        std::vector<std::uint32_t> released;
+        // Listeners subscribed while emitting, appended to the slots once the emit returns
+        std::vector<ListenerSlot<Listener>> pending;
+        std::uint32_t dispatching = 0;
+    };
+
+    struct DeferredQueueBase
+    {
+        virtual ~DeferredQueueBase() = default;
+
+        /** @brief Emits the events queued so far, the ones queued meanwhile wait in the pending buffers. */
+        virtual void Dispatch(EventManager& eventManager) = 0;
+
+        /** @brief Moves the pending events at the end of the pending events of target, a queue of the same type. */
+        virtual void MergeInto(DeferredQueueBase& target) = 0;
+
+        [[nodiscard]] virtual std::unique_ptr<DeferredQueueBase> CreateEmpty() const = 0;
+        [[nodiscard]] virtual bool HasPending() const = 0;
+    };
+
     template <typename T>
-    void Emit(const T& event, void* sender)
+    struct DeferredQueue final : DeferredQueueBase
+    {
+        // Events and senders are kept apart so the events are contiguous for the batch listeners
+        std::vector<T> pendingEvents;
+        std::vector<void*> pendingSenders;
+        std::vector<T> events;
+        std::vector<void*> senders;
+
+        void Dispatch(EventManager& eventManager) override
+        {
+            // Swapping keeps the capacity of both buffers, and the listeners can queue more events safely
+            std::swap(pendingEvents, events);
+            std::swap(pendingSenders, senders);
+
+            const std::uint32_t type = TypeId<T>();
+            if (type < eventManager._listeners.size())
+            {
+                for (std::size_t i = 0; i < events.size(); ++i)
+                {
+                    eventManager.Emit(events[i], senders[i]);
+                }
+            }
+            EventManager::Dispatch(eventManager._batchListeners, type, [this](const TypeErasedBatchListener& listener) {
+                listener(events.data(), events.size());
+            });
+
+            events.clear();
+            senders.clear();
+        }
+
+        void MergeInto(DeferredQueueBase& target) override
+        {
+            auto& typedTarget = static_cast<DeferredQueue&>(target);
+            typedTarget.pendingEvents.insert(typedTarget.pendingEvents.end(), pendingEvents.begin(), pendingEvents.end());
+            typedTarget.pendingSenders.insert(
+                typedTarget.pendingSenders.end(), pendingSenders.begin(), pendingSenders.end()
+            );
+            pendingEvents.clear();
+            pendingSenders.clear();
+        }
+
+        [[nodiscard]] std::unique_ptr<DeferredQueueBase> CreateEmpty() const override
+        {
+            return std::make_unique<DeferredQueue>();
+        }
+
+        [[nodiscard]] bool HasPending() const override
+        {
+            return !pendingEvents.empty();
+        }
+    };
+
+    /**
+     * @brief Deferred queues indexed by type id, with the types that have pending events in the order they were
+     * first queued. The manager has one for its owner thread and one per producer thread.
+     */
+    struct DeferredBuffers
     {
-        const std::type_index typeIndex(typeid(T));
+        std::vector<std::unique_ptr<DeferredQueueBase>> queues;
+        std::vector<std::uint32_t> pendingTypes;
+    };
 
-        LOG_DEBUG("EventManager::Emit: Emitting event: " + std::string(typeid(T).name()));
+    struct Producer
+    {
+        std::thread::id thread;
+        std::unique_ptr<DeferredBuffers> buffers;
+    };
+
+    struct ProducerRegistry
+    {
+        std::mutex mutex;
+        std::vector<Producer> producers;
+    };
+
+    template <typename T>
+    static void QueueDeferred(DeferredBuffers& buffers, const T& event, void* sender)
+    {
+        const std::uint32_t type = TypeId<T>();
+        if (type >= buffers.queues.size())
+        {
+            buffers.queues.resize(type + 1);
+        }
+
+        std::unique_ptr<DeferredQueueBase>& queue = buffers.queues[type];
+        if (!queue)
+        {
+            queue = std::make_unique<DeferredQueue<T>>();
+        }
 
-        if (!_listeners.contains(typeIndex))
+        auto& typedQueue = static_cast<DeferredQueue<T>&>(*queue);
+        if (typedQueue.pendingEvents.empty())
+        {
+            buffers.pendingTypes.push_back(type);
+        }
+        typedQueue.pendingEvents.push_back(event);
+        typedQueue.pendingSenders.push_back(sender);
+    }
+
+    /** @brief Buffers of the calling thread, cached in a thread local after the first lookup. */
+    DeferredBuffers& GetProducerBuffers();
+    void MergeProducers();
+
+    static std::uint32_t NextTypeId();
+
+    template <typename Listener>
+    static EventSubscription AddListener(std::vector<ListenerTable<Listener>>& tables, const std::uint32_t type,
+                                         Listener&& listener)
+    {
+        if (type >= tables.size())
+        {
+            tables.resize(type + 1);
+        }
+
+        ListenerTable<Listener>& table = tables[type];
+        constexpr bool batch = std::is_same_v<Listener, TypeErasedBatchListener>;
+
+        // The emit walks the slots through a raw pointer, they can't grow until it returns
+        if (table.dispatching > 0)
+        {
+            const auto slot = static_cast<std::uint32_t>(table.slots.size() + table.pending.size());
+            table.pending.push_back({.listener = std::move(listener), .generation = 0, .active = true});
+            return {type, slot, 0, batch};
+        }
+
+        std::uint32_t slot;
+        if (table.freeSlots.empty())
+        {
+            slot = static_cast<std::uint32_t>(table.slots.size());
+            table.slots.emplace_back();
+        }
+        else
+        {
+            slot = table.freeSlots.back();
+            table.freeSlots.pop_back();
+        }
+
+        ListenerSlot<Listener>& listenerSlot = table.slots[slot];
+        listenerSlot.listener = std::move(listener);
+        listenerSlot.active = true;
+        return {type, slot, listenerSlot.generation, batch};
+    }
+
+    template <typename Listener, typename Call>
+    static void Dispatch(std::vector<ListenerTable<Listener>>& tables, const std::uint32_t type, Call&& call)
+    {
+        if (type >= tables.size())
         {
             return;
         }
 
-        for (auto& listener : _listeners[typeIndex])
+        // The slot storage of this type stays put while emitting, but a listener subscribing to another type can
+        // grow the table vector, so the table is looked up again afterward
+        ++tables[type].dispatching;
+        const ListenerSlot<Listener>* slots = tables[type].slots.data();
+        const std::size_t count = tables[type].slots.size();
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (slots[i].active)
+            {
+                call(slots[i].listener);
+            }
+        }
+
+        ListenerTable<Listener>& table = tables[type];
+        if (--table.dispatching == 0)
         {
-            listener(&event, sender);
+            ReleaseSlots(table);
+            AddPendingSlots(table);
         }
     }
 
-    template <typename T>
-    void EmitDeferred(const T& event, void* sender)
+    template <typename Listener>
+    static void RemoveListener(ListenerTable<Listener>& table, const EventSubscription& subscription)
     {
-        const std::type_index typeIndex(typeid(T));
+        if (subscription.slot >= table.slots.size())
+        {
+            // Subscribed during the emit still running, it never gets called
+            const std::size_t index = subscription.slot - table.slots.size();
+            if (index < table.pending.size() && table.pending[index].generation == subscription.generation)
+            {
+                table.pending[index].listener = nullptr;
+                table.pending[index].active = false;
+            }
+            return;
+        }
+
+        ListenerSlot<Listener>& slot = table.slots[subscription.slot];
+        if (!slot.active || slot.generation != subscription.generation)
+        {
+            return;
+        }
 
-        LOG_DEBUG("EventManager::EmitDeferred: Queueing event: " + std::string(typeid(T).name()));
+        slot.active = false;
+        ++slot.generation;
+        table.released.push_back(subscription.slot);
 
-        // Create a copy of the event and capture it in the lambda
-        T eventCopy = event;
-        auto eventExecutor = [this, eventCopy, sender]() mutable { this->Emit(eventCopy, sender); };
+        // A listener may unsubscribe itself, so its storage is only released once nothing is emitting
+        if (table.dispatching == 0)
+        {
+            ReleaseSlots(table);
+        }
+    }
 
-        _deferredEvents.emplace_back(typeIndex, std::move(eventExecutor));
+    template <typename Listener>
+    static void ReleaseSlots(ListenerTable<Listener>& table)
+    {
+        for (const std::uint32_t slot : table.released)
+        {
+            table.slots[slot].listener = nullptr;
+            table.freeSlots.push_back(slot);
+        }
+        table.released.clear();
     }
 
-    void ProcessDeferredEvents();
-private:
-    std::map<std::type_index, std::vector<TypeErasedListener>> _listeners;
-    std::vector<DeferredEvent> _deferredEvents;
-};
+    template <typename Listener>
+    static void AddPendingSlots(ListenerTable<Listener>& table)
+    {
+        for (ListenerSlot<Listener>& pending : table.pending)
+        {
+            const auto slot = static_cast<std::uint32_t>(table.slots.size());
+            table.slots.push_back(std::move(pending));
+            if (!table.slots.back().active)
+            {
+                // Unsubscribed before the emit returned, the old handle must not match the next listener
+                ++table.slots.back().generation;
+                table.freeSlots.push_back(slot);
+            }
+        }
+        table.pending.clear();
+    }
 
+    std::vector<ListenerTable<TypeErasedListener>> _listeners;
+    std::vector<ListenerTable<TypeErasedBatchListener>> _batchListeners;
+    DeferredBuffers _deferred;
+    std::vector<std::uint32_t> _dispatchingTypes;
 
+    std::thread::id _ownerThread;
+    // Identifies the manager in the thread local caches, an address could be reused by the next manager
+    std::uint64_t _serial;
+    std::unique_ptr<ProducerRegistry> _producers;
+};
@@ -0,0 +1,72 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include <flecs.h>
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Per-frame storage of the event payloads emitted while the world is deferred.
+ *
+ * The payloads are bump-allocated in blocks that are kept from one frame to the next, and dispatched in emission
+ * order when the EventModule flushes the arena. Reset frees everything at once at the end of the frame, the payloads
+ * must be trivially destructible.
+ */
+class EventArena
+{
+public:
+    static constexpr std::size_t BLOCK_SIZE = 64 * 1024;
+
+    template <typename T>
+    const T& Store(const T& event)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "Event payloads are never destroyed.");
+        return *::new (Allocate(sizeof(T), alignof(T))) T(event);
+    }
+
+    /**
+     * @brief Stores the payload and queues it, it is emitted on the bus by the next Flush.
+     */
+    template <typename T>
+    void Defer(const T& event)
+    {
+        const T& stored = Store(event);
+        _pending.push_back({&stored, [](const flecs::entity& bus, const void* payload) {
+            bus.emit<T>(*static_cast<const T*>(payload));
+        }});
+    }
+
+    /**
+     * @brief Emits the queued events in order, including the ones queued by the observers while flushing.
+     */
+    void Flush(const flecs::world& world);
+
+    /**
+     * @brief Forgets every payload, the blocks are kept for the next frame.
+     */
+    void Reset();
+
+    [[nodiscard]] std::size_t GetPendingCount() const;
+    [[nodiscard]] std::size_t GetBytesUsed() const;
+
+private:
+    struct Pending
+    {
+        const void* payload;
+        void (*emit)(const flecs::entity& bus, const void* payload);
+    };
+
+    void* Allocate(std::size_t size, std::size_t alignment);
+
+    std::vector<std::unique_ptr<std::byte[]>> _blocks;
+    std::vector<std::size_t> _blockSizes;
+    std::size_t _block = 0;
+    std::size_t _offset = 0;
+    std::size_t _bytesUsed = 0;
+    std::vector<Pending> _pending;
+};
@@ -0,0 +1,78 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include "SFE/Modules/Event/EventArena.h"
+
+#include <flecs.h>
+
+#include <cassert>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Entity the engine events are emitted on, `world.entity<EventBus>()`.
+ *
+ * An event is a flecs custom event whose type is the payload type: reacting to a KeyPressed is subscribing an
+ * observer, there is no entity to create, query and destroy.
+ */
+struct EventBus
+{
+};
+
+namespace Events
+{
+
+/**
+ * @brief Emits the event on the bus.
+ *
+ * Outside of the systems the observers are called right away. While the world is deferred the payload is copied in
+ * the EventArena, and the observers are called when the EventModule flushes it: at the start of OnUpdate, then once
+ * more at the end of the frame.
+ *
+ * Main thread only: the arena is one singleton shared by every stage, so a multi_threaded system must not emit on
+ * the bus. Those go through EventManager::EmitDeferred, which keeps a buffer per thread.
+ */
+template <typename T>
+void Emit(const flecs::world& world, const T& event)
+{
+    if (!world.is_deferred())
+    {
+        world.entity<EventBus>().emit<T>(event);
+        return;
+    }
+
+    assert(world.get_stage_id() == 0 && "Events::Emit called from a worker stage, use EventManager::EmitDeferred.");
+    assert(world.has<EventArena>() && "EventArena singleton does not exist, import the EventModule.");
+    world.get_mut<EventArena>().Defer(event);
+}
+
+/**
+ * @brief Calls func(flecs::entity bus, const T& event) for each event of type T, returns the observer.
+ *
+ * The same observer flecs creates for `bus.observe<T>()`, built by hand to hand it back: destroying it ends the
+ * subscription.
+ */
+template <typename T, typename Func>
+flecs::entity Subscribe(const flecs::world& world, Func&& func)
+{
+    struct Delegate
+    {
+        std::decay_t<Func> func;
+    };
+
+    ecs_observer_desc_t desc = {};
+    desc.events[0] = world.id<T>();
+    desc.query.terms[0].id = flecs::Any;
+    desc.query.terms[0].src.id = world.entity<EventBus>();
+    desc.callback = [](ecs_iter_t* it) {
+        auto* delegate = static_cast<Delegate*>(it->callback_ctx);
+        delegate->func(flecs::entity(it->world, ecs_field_src(it, 0)), *static_cast<const T*>(it->param));
+    };
+    desc.callback_ctx = new Delegate{std::forward<Func>(func)};
+    desc.callback_ctx_free = [](void* ctx) { delete static_cast<Delegate*>(ctx); };
+
+    return flecs::entity(world, ecs_observer_init(world, &desc));
+}
+
+} // namespace Events
@@ -0,0 +1,53 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include "SFE/Modules/Input/InputKey.h"
+
+#include <flecs.h>
+
+#include <array>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief EventBindings of the running scenes, flattened from the top-most scene down.
+ *
+ * A key resolves to the binding of the deepest scene that binds it, the scenes below only get the keys the ones above
+ * leave unbound. Keyboard keys index an array directly, the other devices walk a short list.
+ *
+ * The stack is only rebuilt after a scene root, its depth, its pause or its EventBindings changed. Bindings edited in
+ * place must be flagged with modified<EventBindings>() to be seen.
+ */
+class SceneBindingStack
+{
+public:
+    /** @brief Collects the bindings of the running scene roots again. */
+    void Rebuild(const flecs::world& world);
+
+    void Invalidate()
+    {
+        _dirty = true;
+    }
+
+    [[nodiscard]] bool IsDirty() const
+    {
+        return _dirty;
+    }
+
+    /** @brief Binding of the top-most running scene for the key, or a null entity when none binds it. */
+    [[nodiscard]] flecs::entity Resolve(sf::Keyboard::Key key) const;
+    [[nodiscard]] flecs::entity Resolve(const InputKey& key) const;
+
+    [[nodiscard]] std::size_t GetSceneCount() const
+    {
+        return _sceneCount;
+    }
+
+private:
+    std::array<flecs::entity, sf::Keyboard::KeyCount> _keyboard{};
+    // Mouse and joystick bindings, the top-most scene first
+    std::vector<std::pair<decltype(InputKey::id), flecs::entity>> _others;
+    std::size_t _sceneCount = 0;
+    bool _dirty = true;
+};
@@ -4,6 +4,10 @@
 
 /**
  * @brief Tag an entity as a command that is later processed by one or many systems.
+ *
+ * The commands are pooled: once processed, a command stays alive with its Command and Target toggled off, but it still
+ * inherits the tags of its binding prefab. The systems consuming a command must match Command along with its tag, like
+ * `world.query_builder<const Jump>().with<Command>()`, or they see every released command too.
  */
 struct Command
 {
@@ -0,0 +1,98 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include "SFE/Modules/Input/Singletons/InputSnapshot.h"
+
+#include <SFML/Window.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+/**
+ * @brief Writes the window events and the input snapshot of every frame to a binary stream, to be replayed later.
+ *
+ * The stream starts with a short header. Each frame then has its delta time, its events, the snapshot controls that
+ * flipped since the previous frame, and the joystick axes that moved. Integers are varints, control indices and mouse
+ * positions are stored as deltas, so an idle frame takes seven bytes.
+ */
+class InputRecorder
+{
+public:
+    explicit InputRecorder(const std::filesystem::path& path);
+
+    [[nodiscard]] bool IsOpen() const;
+
+    /**
+     * @brief Keeps the event for the current frame. Closing the window and the events the engine does not translate
+     * are dropped.
+     */
+    void RecordEvent(const sf::Event& event);
+
+    /** @brief Writes the frame with the delta time it was run with, once the snapshot has been updated for it. */
+    void EndFrame(const InputSnapshot& snapshot, float deltaTime);
+
+    [[nodiscard]] std::uint64_t GetFrameCount() const
+    {
+        return _frameCount;
+    }
+
+private:
+    std::ofstream _stream;
+    // Events of the current frame, already encoded
+    std::vector<std::uint8_t> _events;
+    std::uint64_t _eventCount = 0;
+    std::vector<std::uint8_t> _frame;
+
+    InputSnapshot::Bits _live;
+    InputSnapshot::Axes _axes{};
+    sf::Vector2i _mousePosition;
+    std::uint64_t _frameCount = 0;
+};
+
+/**
+ * @brief Reads back a stream written by InputRecorder, one frame at a time.
+ */
+class InputReplay
+{
+public:
+    explicit InputReplay(const std::filesystem::path& path);
+
+    [[nodiscard]] bool IsOpen() const;
+
+    /** @brief Reads the next frame, returns false at the end of the stream or when the frame is truncated. */
+    bool NextFrame();
+
+    /** @brief Delta time the frame was recorded with, the replay must progress the world by it to stay in sync. */
+    [[nodiscard]] float GetDeltaTime() const
+    {
+        return _deltaTime;
+    }
+
+    /** @brief Window events of the frame, in the order they were polled. */
+    [[nodiscard]] const std::vector<sf::Event>& GetEvents() const
+    {
+        return _events;
+    }
+
+    /** @brief Feeds the recorded controls and axes of the frame to the snapshot, after its events were applied. */
+    void ApplyTo(InputSnapshot& snapshot) const;
+
+    [[nodiscard]] std::uint64_t GetFrameCount() const
+    {
+        return _frameCount;
+    }
+
+private:
+    std::ifstream _stream;
+    bool _valid = false;
+    float _deltaTime = 0.f;
+
+    std::vector<sf::Event> _events;
+    InputSnapshot::Bits _live;
+    InputSnapshot::Axes _axes{};
+    sf::Vector2i _mousePosition;
+    std::uint64_t _frameCount = 0;
+};
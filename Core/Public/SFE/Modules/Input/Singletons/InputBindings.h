@@ -3,13 +3,67 @@
 #pragma once
 
 #include "SFE/Modules/Input/InputKey.h"
+#include "SFE/Modules/Input/Singletons/InputSnapshot.h"
 
+#include <cstdint>
 #include <unordered_map>
+#include <vector>
 
 
-struct InputBindings
+struct CompiledInputBinding
 {
-    std::unordered_map<InputKey, flecs::entity, InputKeyHash> map;
+    InputSnapshot::Control control = InputSnapshot::INVALID_CONTROL;
+    flecs::entity prefab;
 };
 
+/**
+ * @brief Input bindings of the possessed entities, a key mapped to the command prefab it spawns.
+ *
+ * The map is only edited through Bind and Unbind, which bump the version. The InputModule compiles the bindings again
+ * whenever the version changed, whether the singleton was set or edited in place through get_mut.
+ */
+class InputBindings
+{
+public:
+    using Map = std::unordered_map<InputKey, flecs::entity, InputKeyHash>;
+
+    /** @brief Maps the key to the command prefab, replacing the prefab it was bound to. */
+    void Bind(const InputKey& key, const flecs::entity prefab)
+    {
+        _map.insert_or_assign(key, prefab);
+        ++_version;
+    }
+
+    void Unbind(const InputKey& key)
+    {
+        if (_map.erase(key) > 0)
+        {
+            ++_version;
+        }
+    }
+
+    void Clear()
+    {
+        _map.clear();
+        ++_version;
+    }
 
+    [[nodiscard]] const Map& GetMap() const
+    {
+        return _map;
+    }
+
+    [[nodiscard]] std::uint64_t GetVersion() const
+    {
+        return _version;
+    }
+
+    // Filled from the map by the InputModule before the snapshot update, one snapshot control per binding
+    std::vector<CompiledInputBinding> compiled;
+    // Version of the map the compiled bindings were built from
+    std::uint64_t compiledVersion = 0;
+
+private:
+    Map _map;
+    std::uint64_t _version = 1;
+};
@@ -0,0 +1,132 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include "SFE/Modules/Input/InputKey.h"
+
+#include <array>
+#include <bitset>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief State of every input control for the current frame, with the edges from the previous one.
+ *
+ * Keys, mouse buttons, joystick buttons and joystick axis directions each get a control index into one bitset. The
+ * keyboard and the mouse are fed by the window events, the connected joysticks are polled once per frame in Update,
+ * so reading an input is a bit test and never reaches into SFML.
+ *
+ * A joystick axis direction becomes a control once a binding is compiled for it, with the dead zone of that binding.
+ */
+class InputSnapshot
+{
+public:
+    using Control = std::uint16_t;
+
+    static constexpr std::size_t KEYS = sf::Keyboard::KeyCount;
+    static constexpr std::size_t MOUSE_BUTTONS = sf::Mouse::ButtonCount;
+    static constexpr std::size_t JOYSTICKS = sf::Joystick::Count;
+    static constexpr std::size_t JOYSTICK_BUTTONS = sf::Joystick::ButtonCount;
+    static constexpr std::size_t JOYSTICK_AXES = sf::Joystick::AxisCount;
+    static constexpr std::size_t MAX_AXIS_CONTROLS = 32;
+
+    static constexpr std::size_t MOUSE_OFFSET = KEYS;
+    static constexpr std::size_t JOYSTICK_OFFSET = MOUSE_OFFSET + MOUSE_BUTTONS;
+    static constexpr std::size_t AXIS_OFFSET = JOYSTICK_OFFSET + JOYSTICKS * JOYSTICK_BUTTONS;
+    static constexpr std::size_t CONTROLS = AXIS_OFFSET + MAX_AXIS_CONTROLS;
+    static constexpr Control INVALID_CONTROL = 0xFFFF;
+
+    using Bits = std::bitset<CONTROLS>;
+    using Axes = std::array<float, JOYSTICKS * JOYSTICK_AXES>;
+
+    /**
+     * @brief Keeps track of the keyboard and mouse buttons from a window event, until the next Update.
+     */
+    void Apply(const sf::Event& event);
+
+    /**
+     * @brief Starts a new frame: polls the joysticks and moves the current state to the previous one.
+     *
+     * A key pressed and released since the last update still counts as held for this frame.
+     */
+    void Update();
+
+    /**
+     * @brief Control index of the key, registering its axis direction when it's a joystick axis. Returns
+     * INVALID_CONTROL when the key is out of range or there is no room left for another axis direction.
+     */
+    Control Compile(const InputKey& key);
+
+    /** @brief Forgets the axis directions registered by Compile, before compiling the bindings again. */
+    void ClearAxisControls();
+
+    [[nodiscard]] bool IsHeld(const Control control) const
+    {
+        assert(control < CONTROLS && "InputSnapshot::IsHeld: invalid control");
+        return _held[control];
+    }
+
+    /** @brief The control went down this frame. */
+    [[nodiscard]] bool IsPressed(const Control control) const
+    {
+        assert(control < CONTROLS && "InputSnapshot::IsPressed: invalid control");
+        return _held[control] && !_previous[control];
+    }
+
+    /** @brief The control went up this frame. */
+    [[nodiscard]] bool IsReleased(const Control control) const
+    {
+        assert(control < CONTROLS && "InputSnapshot::IsReleased: invalid control");
+        return !_held[control] && _previous[control];
+    }
+
+    /** @brief Position of the joystick axis in [-100, 100] as of the last Update. */
+    [[nodiscard]] float GetAxis(const unsigned joystick, const sf::Joystick::Axis axis) const
+    {
+        return _axes[joystick * JOYSTICK_AXES + static_cast<std::size_t>(axis)];
+    }
+
+    [[nodiscard]] const Bits& GetHeld() const
+    {
+        return _held;
+    }
+
+    /** @brief State of the controls as the events and the last poll left them, before the next Update. */
+    [[nodiscard]] const Bits& GetLive() const
+    {
+        return _live;
+    }
+
+    [[nodiscard]] const Axes& GetAxes() const
+    {
+        return _axes;
+    }
+
+    /**
+     * @brief Replaces the state of the controls and the joystick axes, for a replay feeding the input without the
+     * devices. From then on Update stops polling the joysticks.
+     */
+    void Override(const Bits& live, const Axes& axes);
+
+private:
+    struct AxisControl
+    {
+        unsigned joystick;
+        sf::Joystick::Axis axis;
+        int direction;
+        float deadZone;
+    };
+
+    void SampleJoysticks();
+
+    // Updated by the events as they come
+    Bits _live;
+    // Controls pressed since the last update, so a tap shorter than a frame is not lost
+    Bits _tapped;
+    Bits _held;
+    Bits _previous;
+    Axes _axes{};
+    std::vector<AxisControl> _axisControls;
+    bool _overridden = false;
+};
@@ -2,7 +2,19 @@
 
 #pragma once
 
+#include <cstdint>
+
+/**
+ * @brief Destroys the entity after the given time, counted from the moment the component is set.
+ *
+ * The LifetimeModule schedules the entity in its LifetimeWheel on set, setting it again restarts the countdown.
+ * seconds keeps the duration it was set with and doesn't count down, the time left is
+ * `LifetimeWheel::GetRemaining(expiryTick)`.
+ */
 struct Lifetime
 {
+    // Total duration, not the time left
     float seconds = 0.f;
+    // Tick of the LifetimeWheel at which the entity expires, filled in when it is scheduled
+    std::uint64_t expiryTick = 0;
 };
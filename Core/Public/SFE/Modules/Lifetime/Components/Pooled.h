@@ -0,0 +1,13 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include <flecs.h>
+
+/**
+ * @brief Entity owned by the EntityPool: at the end of its life it is disabled and kept for reuse, not destroyed.
+ */
+struct Pooled
+{
+    flecs::entity_t prefab = 0;
+};
@@ -0,0 +1,52 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include <flecs.h>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Recycles the short-lived instances of a prefab, like the input events and the commands.
+ *
+ * Creating and destroying an entity each frame moves it through several tables and recycles its id. A released
+ * instance stays where it is instead: its components registered with flecs::CanToggle are toggled off, which hides it
+ * from the queries matching them, and toggled on again when it's acquired. Only the first release moves the entity
+ * once, to the table holding the toggle bits, in steady state nothing is allocated and no entity changes table. The
+ * LifetimeOneFrameSystem releases the pooled entities instead of destroying them.
+ *
+ * The queries only skip a free instance through its toggled components. The components inherited from the prefab can't
+ * be toggled, a query matching only those still sees the free instances, so the consumers must match one component
+ * the instance owns and toggles, like Command for the commands. LifetimeOneFrame and the engine's event and command
+ * components can toggle, a game pooling its own prefabs must register the components its systems match with
+ * flecs::CanToggle, before any entity has them.
+ */
+class EntityPool
+{
+public:
+    /**
+     * @brief A released instance of the prefab with its components toggled on again, or a new one when none is free.
+     */
+    flecs::entity Acquire(const flecs::world& world, flecs::entity_t prefab);
+
+    /**
+     * @brief Toggles the components of the entity off and copies the prefab's values back into the ones it overrides.
+     * The values are reset in place, the OnSet observers are not called.
+     */
+    void Release(flecs::entity entity);
+
+    [[nodiscard]] std::size_t GetFreeCount(flecs::entity_t prefab) const;
+
+    /** @brief Entities created because no instance was free, it stops growing once the pool is warm. */
+    [[nodiscard]] std::uint64_t GetCreatedCount() const;
+    [[nodiscard]] std::uint64_t GetReusedCount() const;
+
+private:
+    std::unordered_map<flecs::entity_t, std::vector<flecs::entity_t>> _free;
+    std::uint64_t _created = 0;
+    std::uint64_t _reused = 0;
+    // Scratch for the ids toggled by Acquire and Release
+    std::vector<flecs::id_t> _toggled;
+};
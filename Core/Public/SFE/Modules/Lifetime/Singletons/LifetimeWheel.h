@@ -0,0 +1,70 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include <flecs.h>
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * @brief Hierarchical timing wheel holding the expiry of every entity with a Lifetime.
+ *
+ * Time is cut in ticks of 1/TICKS_PER_SECOND seconds. The first level has one slot per tick for the next SLOTS ticks,
+ * each level above has slots SLOTS times longer. An entity is inserted once in the slot matching its expiry, and
+ * slots of the upper levels are spread over the level below when the time reaches them. Advancing the wheel only
+ * touches the slots of the elapsed ticks, the cost follows the expirations and not the number of timed entities.
+ *
+ * Entries are never removed: the expired entities are checked against the expiryTick of their Lifetime, so an entity
+ * destroyed or rescheduled since is simply skipped.
+ */
+class LifetimeWheel
+{
+public:
+    static constexpr std::uint64_t TICKS_PER_SECOND = 240;
+    static constexpr std::uint64_t SLOT_BITS = 8;
+    static constexpr std::uint64_t SLOTS = 1 << SLOT_BITS;
+    static constexpr std::size_t LEVELS = 4;
+
+    /**
+     * @brief Schedules the entity to expire after the given time and returns the tick it will expire on.
+     */
+    std::uint64_t Schedule(flecs::entity_t entity, float seconds);
+
+    /**
+     * @brief Moves the time forward and returns the entities due by then, possibly stale. The span points into a
+     * buffer of the wheel, valid until the next call.
+     */
+    std::span<const flecs::entity_t> Advance(float deltaTime);
+
+    /** @brief Seconds elapsed since the wheel was created. */
+    [[nodiscard]] double GetTime() const;
+
+    /** @brief Next tick to be processed, every tick before it has expired. */
+    [[nodiscard]] std::uint64_t GetTick() const;
+
+    /** @brief Seconds left before the given expiry tick, negative once it is past. */
+    [[nodiscard]] float GetRemaining(std::uint64_t expiryTick) const;
+
+    /** @brief Entries waiting in the wheel, including the stale ones. */
+    [[nodiscard]] std::size_t Size() const;
+
+private:
+    struct Entry
+    {
+        flecs::entity_t entity;
+        std::uint64_t expiryTick;
+    };
+
+    void Insert(const Entry& entry);
+    void Cascade(std::size_t level);
+
+    std::array<std::array<std::vector<Entry>, SLOTS>, LEVELS> _slots;
+    std::uint64_t _tick = 0;
+    double _time = 0.0;
+    std::size_t _size = 0;
+    // Kept between the calls of Advance, the expirations don't allocate once it has grown
+    std::vector<flecs::entity_t> _expired;
+};
@@ -7,4 +7,7 @@
 struct Particle
 {
     sf::Color color = sf::Color::White;
+    float size = 1.f;
+    // Lifetime the particle was spawned with, to know its age for the curves of the emitter
+    float lifetime = 0.f;
 };
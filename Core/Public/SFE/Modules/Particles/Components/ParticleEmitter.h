@@ -2,20 +2,53 @@
 
 #pragma once
 
+#include "SFE/Modules/Particles/ParticleBuffer.h"
+#include "SFE/Modules/Particles/ParticleCurves.h"
 #include "SFE/Modules/Render/Components/Transform.h"
 
+#include <SFML/Graphics/Color.hpp>
+
 #include <flecs.h>
 #include <functional>
+#include <span>
 
 
 struct ParticleEmitter;
+
+enum class ParticleStorage
+{
+    // Every particle is an entity, integrated by the physics and culled by the lifetime systems
+    Entities,
+    // The particles live in the ParticleBuffer of the emitter and never touch the ECS
+    Buffer
+};
+
+/**
+ * @brief The particles of one spawn, one entry per particle in every span. The generator fills them all in one call.
+ */
+struct ParticleSpawnBatch
+{
+    std::span<sf::Vector2f> positions;
+    std::span<sf::Vector2f> velocities;
+    std::span<float> lifetimes;
+    std::span<sf::Color> colors;
+
+    [[nodiscard]] std::size_t Size() const
+    {
+        return positions.size();
+    }
+};
+
 using ParticleGenerator = std::function<flecs::entity(flecs::world, const ParticleEmitter&, const Transform&)>;
+using ParticleBatchGenerator = std::function<void(const ParticleEmitter&, const Transform&, const ParticleSpawnBatch&)>;
 
 struct ParticleEmitter
 {
     // Tuning
     float ratePerSecond{100.f};
     int maxParticles{1000};
+    // Higher priorities keep more of their rate when the ParticleBudget throttles the spawns
+    int priority{0};
 
     // Particle settings
     float minLifetime{0.5f};
@@ -23,18 +56,31 @@ struct ParticleEmitter
     float minVelocity{20.f};
     float maxVelocity{80.f};
 
-    // The emitter itself has a Transform rotation
-    float minAngleDeg{-10.f};
-    float maxAngleDeg{10.f};
+    // Spawn direction relative to the rotation of the emitter Transform, all around by default, narrow it for a cone
+    float minAngleDeg{-180.f};
+    float maxAngleDeg{180.f};
+
+    sf::Color color{sf::Color::White};
+    ParticleCurves curves;
 
     // State
     bool enabled{true};
     bool loop{false};
 
-    // Custom particle generator
+    ParticleStorage storage{ParticleStorage::Entities};
+
+    // Custom generator filling a whole spawn at once, for both storages. The default one is used when empty.
+    ParticleBatchGenerator batchGenerator;
+    // Custom per particle generator, only used by the Entities storage. Each call creates and moves an entity through
+    // several tables, prefer the batchGenerator.
     ParticleGenerator generator;
 
     // Runtime
     float spawnAccumulator{0.f};
+    // Particles alive right now, kept up to date on spawn and death so the cap costs nothing to enforce
+    int liveParticles{0};
+    ParticleBuffer particles;
+    // Baked from the curves each time the emitter is set, set it again after changing the curves
+    ParticleCurveTables curveTables;
 };
 
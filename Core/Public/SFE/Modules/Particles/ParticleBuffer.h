@@ -0,0 +1,75 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <vector>
+
+/**
+ * @brief Particles of one emitter stored as parallel arrays, one entry per live particle.
+ *
+ * A particle is only an index: it is appended on spawn and swap-removed on death, so the arrays stay dense and a
+ * system can walk them linearly without touching the ECS.
+ */
+struct ParticleBuffer
+{
+    std::vector<sf::Vector2f> positions;
+    std::vector<sf::Vector2f> velocities;
+    std::vector<float> ages;
+    std::vector<float> lifetimes;
+    std::vector<sf::Color> colors;
+    std::vector<float> sizes;
+
+    [[nodiscard]] std::size_t Size() const
+    {
+        return positions.size();
+    }
+
+    void Reserve(const std::size_t capacity)
+    {
+        positions.reserve(capacity);
+        velocities.reserve(capacity);
+        ages.reserve(capacity);
+        lifetimes.reserve(capacity);
+        colors.reserve(capacity);
+        sizes.reserve(capacity);
+    }
+
+    /**
+     * @brief Appends count particles aged 0 and 1 pixel wide and returns the index of the first one, for the
+     * generator to fill in.
+     */
+    std::size_t Grow(const std::size_t count)
+    {
+        const std::size_t first = Size();
+        positions.resize(first + count);
+        velocities.resize(first + count);
+        ages.resize(first + count, 0.f);
+        lifetimes.resize(first + count);
+        colors.resize(first + count);
+        sizes.resize(first + count, 1.f);
+        return first;
+    }
+
+    /**
+     * @brief Moves the last particle into the slot, the order of the particles is not kept.
+     */
+    void SwapRemove(const std::size_t index)
+    {
+        positions[index] = positions.back();
+        velocities[index] = velocities.back();
+        ages[index] = ages.back();
+        lifetimes[index] = lifetimes.back();
+        colors[index] = colors.back();
+        sizes[index] = sizes.back();
+
+        positions.pop_back();
+        velocities.pop_back();
+        ages.pop_back();
+        lifetimes.pop_back();
+        colors.pop_back();
+        sizes.pop_back();
+    }
+};
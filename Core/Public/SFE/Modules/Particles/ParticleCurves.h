@@ -0,0 +1,81 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include <SFML/Graphics/Color.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+template <typename T>
+struct ParticleCurveKey
+{
+    // Normalised age of the particle, 0 at spawn and 1 at death
+    float time = 0.f;
+    T value{};
+};
+
+/**
+ * @brief Properties of the particles over their life, linearly interpolated between keys sorted by time.
+ *
+ * An empty curve leaves the property as the generator spawned it.
+ */
+struct ParticleCurves
+{
+    std::vector<ParticleCurveKey<sf::Color>> color;
+    // Overrides the alpha of the color, from 0 to 1
+    std::vector<ParticleCurveKey<float>> alpha;
+    // Side of the particle in pixels, a particle of 1 pixel or less is drawn as a point
+    std::vector<ParticleCurveKey<float>> size;
+};
+
+/**
+ * @brief The curves of an emitter sampled at evenly spaced ages, baked when the emitter is set.
+ *
+ * Evaluating a curve for a particle is a single fetch at the index of its normalised age.
+ */
+struct ParticleCurveTables
+{
+    static constexpr std::size_t RESOLUTION = 64;
+
+    std::array<sf::Color, RESOLUTION> colors{};
+    std::array<std::uint8_t, RESOLUTION> alphas{};
+    std::array<float, RESOLUTION> sizes{};
+
+    bool hasColor = false;
+    bool hasAlpha = false;
+    bool hasSize = false;
+
+    [[nodiscard]] bool IsEmpty() const
+    {
+        return !hasColor && !hasAlpha && !hasSize;
+    }
+
+    [[nodiscard]] static std::size_t Index(const float age, const float lifetime)
+    {
+        const float normalised = lifetime > 0.f ? age / lifetime : 1.f;
+        const float index = std::clamp(normalised, 0.f, 1.f) * static_cast<float>(RESOLUTION - 1) + 0.5f;
+        return static_cast<std::size_t>(index);
+    }
+
+    /**
+     * @brief Applies the baked curves for the given index, the properties without a curve are left untouched.
+     */
+    void Apply(const std::size_t index, sf::Color& color, float& size) const
+    {
+        if (hasColor)
+        {
+            color = colors[index];
+        }
+        if (hasAlpha)
+        {
+            color.a = alphas[index];
+        }
+        if (hasSize)
+        {
+            size = sizes[index];
+        }
+    }
+};
@@ -0,0 +1,29 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include <chrono>
+
+/**
+ * Pure functions behind the particle budget, they only depend on their arguments so synthetic timings can drive them.
+ */
+namespace ParticleThrottle
+{
+
+/**
+ * @brief Next throttle after a frame where the particles took `measured`.
+ *
+ * Over budget, the throttle is scaled by budget / measured so the next frame should fit. Under budget, it recovers
+ * linearly by recoveryPerSecond, capped at 1.
+ */
+float Update(float throttle, std::chrono::nanoseconds measured, std::chrono::nanoseconds budget, float deltaTime,
+             float recoveryPerSecond);
+
+/**
+ * @brief Share of its rate an emitter spawns at for the given throttle.
+ *
+ * Priority 0 follows the throttle, each priority above keeps more of its rate: throttle ^ (1 / (1 + priority)).
+ */
+float RateScale(float throttle, int priority);
+
+} // namespace ParticleThrottle
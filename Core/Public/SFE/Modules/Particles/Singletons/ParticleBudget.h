@@ -0,0 +1,33 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include <chrono>
+
+/**
+ * @brief Global limits of the particles, shared by every emitter.
+ *
+ * The emitters never spawn past maxParticles live particles. When the particles took more than frameBudget to
+ * update and render, the throttle drops and every emitter spawns at a fraction of its ratePerSecond, the lower
+ * priorities losing the most. The throttle recovers progressively once the particles are back under budget.
+ */
+struct ParticleBudget
+{
+    int maxParticles = 200'000;
+    std::chrono::microseconds frameBudget{2'000};
+    // Throttle regained per second while under budget, 0.5 gets back to full rate in two seconds
+    float recoveryPerSecond = 0.5f;
+
+    // Runtime
+    int liveParticles = 0;
+    std::chrono::nanoseconds updateTime{0};
+    std::chrono::nanoseconds renderTime{0};
+    // Update and render time of the last frame, the throttle was computed from it
+    std::chrono::nanoseconds lastFrameTime{0};
+    // Share of their rate the emitters of priority 0 spawn at, from 0 to 1
+    float throttle = 1.f;
+
+    // Frames over the time budget, and spawns cut short by maxParticles
+    int budgetHits = 0;
+    int capHits = 0;
+};
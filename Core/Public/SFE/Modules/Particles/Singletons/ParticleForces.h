@@ -0,0 +1,42 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+
+#include <vector>
+
+/**
+ * @brief Pulls the particles toward its position, with a strength falling off with the squared distance.
+ */
+struct ParticleAttractor
+{
+    sf::Vector2f position;
+    float strength = 0.f;
+    // Particles further away are not affected
+    float radius = 100.f;
+};
+
+/**
+ * @brief Spins the particles around its position, counter-clockwise for a positive strength.
+ */
+struct ParticleVortex
+{
+    sf::Vector2f position;
+    float strength = 0.f;
+    float radius = 100.f;
+};
+
+/**
+ * @brief Global forces applied to every buffered particle, evaluated in the same pass as the integration.
+ *
+ * Each attractor and vortex costs one more sweep over the particles, keep them to a handful.
+ */
+struct ParticleForces
+{
+    sf::Vector2f gravity;
+    // Fraction of the velocity lost per second
+    float drag = 0.f;
+    std::vector<ParticleAttractor> attractors;
+    std::vector<ParticleVortex> vortices;
+};
@@ -0,0 +1,26 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include <cstdint>
+
+namespace CollisionLayer
+{
+constexpr std::uint32_t None = 0u;
+constexpr std::uint32_t Default = 1u << 0;
+// Clickable UI elements, put there by the UIModule so its hit test only asks the SpatialQuery for them
+constexpr std::uint32_t UI = 1u << 31;
+constexpr std::uint32_t All = ~0u;
+} // namespace CollisionLayer
+
+/**
+ * @brief Layer bitmask of a collider and the layers it collides with.
+ *
+ * Two bodies collide only when each one's layer is in the other one's mask. Filtered pairs are never generated by the
+ * broadphase. Colliders without a CollisionFilter are on the Default layer and collide with everything.
+ */
+struct CollisionFilter
+{
+    std::uint32_t layer = CollisionLayer::Default;
+    std::uint32_t mask = CollisionLayer::All;
+};
@@ -0,0 +1,13 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+/**
+ * @brief Opt-in swept collision for small and fast bodies (bullets, fast balls...) that would otherwise tunnel.
+ *
+ * The body is rewound to its first time of impact along the motion of the step, the regular contact resolution takes
+ * it from there. Only flagged bodies pay for it.
+ */
+struct ContinuousCollision
+{
+};
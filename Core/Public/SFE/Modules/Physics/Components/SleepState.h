@@ -0,0 +1,18 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Tracks how long a body has been at rest and, once asleep, which island it sleeps with.
+ *
+ * Every ColliderShape comes with a SleepState. When a whole island of touching bodies stayed below the
+ * SleepSettings threshold long enough, their Velocity is toggled off so the integrator and the broadphase skip them.
+ */
+struct SleepState
+{
+    float idleTime = 0.f;
+    // 0 when the body is awake
+    std::uint32_t island = 0;
+};
@@ -0,0 +1,14 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+/**
+ * @brief Walls and level geometry: a collider that never moves.
+ *
+ * Statics are baked into an immutable BVH, rebuilt only when a static is added, removed or moved. They are skipped by
+ * the movement and the broadphase, only the dynamic bodies query them, so static-vs-static pairs never exist.
+ * The shape comes from the ColliderShape: a Radius centered on the position, or a Size starting at the position.
+ */
+struct StaticCollider
+{
+};
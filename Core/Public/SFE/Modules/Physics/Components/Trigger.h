@@ -0,0 +1,18 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+
+/**
+ * @brief Sensor volume that reports the bodies entering, staying in and leaving it, without colliding with them.
+ *
+ * The volume is a box starting at the Transform position, like the UI hit boxes. Triggers are static: they are baked
+ * in a spatial grid when the Trigger or the Transform is set, so set one of them again to move a trigger.
+ *
+ * The events of the step are written in the TriggerEvents of the trigger.
+ */
+struct Trigger
+{
+    sf::Vector2f size;
+};
@@ -0,0 +1,18 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include <flecs.h>
+#include <vector>
+
+/**
+ * @brief Bodies that entered, stayed in or left a Trigger during the last physics step.
+ *
+ * Only the triggers listed in the ActiveTriggers singleton have events, the other ones are left untouched.
+ */
+struct TriggerEvents
+{
+    std::vector<flecs::entity> entered;
+    std::vector<flecs::entity> stayed;
+    std::vector<flecs::entity> exited;
+};
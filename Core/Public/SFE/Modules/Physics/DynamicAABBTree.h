@@ -0,0 +1,261 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <vector>
+
+#include <cassert>
+#include <cstdint>
+
+/**
+ * @brief Bounding volume hierarchy of fattened AABBs, balanced with AVL rotations (same design as Box2D's tree).
+ *
+ * Leaves are proxies identified by their node index, which stays valid until the proxy is destroyed. The stored AABB
+ * is fattened by a margin so a proxy moving a little doesn't touch the tree at all, MoveProxy only reinserts it once
+ * it leaves its fat AABB.
+ */
+class DynamicAABBTree
+{
+public:
+    static constexpr std::int32_t NULL_NODE = -1;
+
+    // How much the AABBs are fattened, in pixels
+    static constexpr float AABB_MARGIN = 8.f;
+    // Fattens the AABB in the direction of the motion so a moving proxy is reinserted less often
+    static constexpr float DISPLACEMENT_MULTIPLIER = 2.f;
+
+    std::int32_t CreateProxy(const sf::FloatRect& aabb, std::uint64_t userData);
+    void DestroyProxy(std::int32_t proxy);
+
+    /**
+     * @return true when the proxy left its fat AABB and had to be reinserted
+     */
+    bool MoveProxy(std::int32_t proxy, const sf::FloatRect& aabb, const sf::Vector2f& displacement);
+
+    [[nodiscard]] std::uint64_t GetUserData(std::int32_t proxy) const;
+    [[nodiscard]] sf::FloatRect GetFatAABB(std::int32_t proxy) const;
+    [[nodiscard]] std::int32_t GetHeight() const;
+    [[nodiscard]] std::size_t GetProxyCount() const;
+    [[nodiscard]] std::size_t GetNodeCapacity() const;
+
+    /**
+     * @brief Calls func(proxy) for each proxy whose fat AABB overlaps the AABB. Return false from func to stop.
+     */
+    template <typename Func>
+    void Query(const sf::FloatRect& aabb, Func&& func) const
+    {
+        if (_root == NULL_NODE)
+        {
+            return;
+        }
+
+        const Bounds bounds = ToBounds(aabb);
+
+        std::array<std::int32_t, STACK_CAPACITY> stack;
+        std::size_t count = 0;
+        stack[count++] = _root;
+
+        while (count > 0)
+        {
+            const std::int32_t index = stack[--count];
+            const Node& node = _nodes[index];
+            if (!Overlaps(node.aabb, bounds))
+            {
+                continue;
+            }
+
+            if (node.IsLeaf())
+            {
+                if (!func(index))
+                {
+                    return;
+                }
+                continue;
+            }
+
+            assert(count + 2 <= STACK_CAPACITY && "DynamicAABBTree traversal stack overflow");
+            stack[count++] = node.child1;
+            stack[count++] = node.child2;
+        }
+    }
+
+    /**
+     * @brief Calls func(proxy, maxFraction) for each proxy whose fat AABB is crossed by the segment from `from` to `to`.
+     *
+     * func returns the new max fraction of the segment: the same value to keep going, a lower one to clip the
+     * segment (e.g. the fraction of a hit when only the closest one matters), and 0 to stop.
+     */
+    template <typename Func>
+    void RayCast(const sf::Vector2f& from, const sf::Vector2f& to, Func&& func) const
+    {
+        if (_root == NULL_NODE)
+        {
+            return;
+        }
+
+        const sf::Vector2f direction = to - from;
+        float maxFraction = 1.f;
+
+        std::array<std::int32_t, STACK_CAPACITY> stack;
+        std::size_t count = 0;
+        stack[count++] = _root;
+
+        while (count > 0)
+        {
+            const std::int32_t index = stack[--count];
+            const Node& node = _nodes[index];
+            if (!SegmentOverlaps(node.aabb, from, direction, maxFraction))
+            {
+                continue;
+            }
+
+            if (node.IsLeaf())
+            {
+                maxFraction = func(index, maxFraction);
+                if (maxFraction <= 0.f)
+                {
+                    return;
+                }
+                continue;
+            }
+
+            assert(count + 2 <= STACK_CAPACITY && "DynamicAABBTree traversal stack overflow");
+            stack[count++] = node.child1;
+            stack[count++] = node.child2;
+        }
+    }
+
+    /**
+     * @brief Visits the proxies closest to the point first.
+     *
+     * func(proxy) returns the squared distance beyond which proxies are not interesting anymore (e.g. the distance of
+     * the k-th closest hit so far), the subtrees further away than that are pruned.
+     */
+    template <typename Func>
+    void QueryNearest(const sf::Vector2f& point, Func&& func) const
+    {
+        if (_root == NULL_NODE)
+        {
+            return;
+        }
+
+        struct Entry
+        {
+            std::int32_t node;
+            float distanceSquared;
+        };
+
+        float maxDistanceSquared = std::numeric_limits<float>::max();
+
+        std::array<Entry, STACK_CAPACITY> stack;
+        std::size_t count = 0;
+        stack[count++] = {_root, DistanceSquared(_nodes[_root].aabb, point)};
+
+        while (count > 0)
+        {
+            const auto [index, distanceSquared] = stack[--count];
+            if (distanceSquared > maxDistanceSquared)
+            {
+                continue;
+            }
+
+            const Node& node = _nodes[index];
+            if (node.IsLeaf())
+            {
+                maxDistanceSquared = func(index);
+                continue;
+            }
+
+            // Push the farthest child first so the closest one is visited first
+            Entry near = {node.child1, DistanceSquared(_nodes[node.child1].aabb, point)};
+            Entry far = {node.child2, DistanceSquared(_nodes[node.child2].aabb, point)};
+            if (far.distanceSquared < near.distanceSquared)
+            {
+                std::swap(near, far);
+            }
+
+            assert(count + 2 <= STACK_CAPACITY && "DynamicAABBTree traversal stack overflow");
+            stack[count++] = far;
+            stack[count++] = near;
+        }
+    }
+
+private:
+    // A balanced tree of a few million proxies is about 40 levels deep, the traversal never holds more than that
+    static constexpr std::size_t STACK_CAPACITY = 256;
+
+    struct Bounds
+    {
+        sf::Vector2f min;
+        sf::Vector2f max;
+    };
+
+    struct Node
+    {
+        Bounds aabb;
+        std::uint64_t userData = 0;
+        // Next free node when the node is in the free list
+        std::int32_t parent = NULL_NODE;
+        std::int32_t child1 = NULL_NODE;
+        std::int32_t child2 = NULL_NODE;
+        // Leaves are 0, free nodes are -1
+        std::int32_t height = -1;
+
+        [[nodiscard]] bool IsLeaf() const
+        {
+            return child1 == NULL_NODE;
+        }
+    };
+
+    static Bounds ToBounds(const sf::FloatRect& rect)
+    {
+        return {rect.position, rect.position + rect.size};
+    }
+
+    static Bounds Union(const Bounds& a, const Bounds& b)
+    {
+        return {{std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y)}, {std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y)}};
+    }
+
+    static float Perimeter(const Bounds& b)
+    {
+        return 2.f * ((b.max.x - b.min.x) + (b.max.y - b.min.y));
+    }
+
+    static bool Contains(const Bounds& outer, const Bounds& inner)
+    {
+        return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && inner.max.x <= outer.max.x &&
+               inner.max.y <= outer.max.y;
+    }
+
+    static bool Overlaps(const Bounds& a, const Bounds& b)
+    {
+        return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y;
+    }
+
+    static float DistanceSquared(const Bounds& b, const sf::Vector2f& point)
+    {
+        const float dx = std::max({b.min.x - point.x, 0.f, point.x - b.max.x});
+        const float dy = std::max({b.min.y - point.y, 0.f, point.y - b.max.y});
+        return dx * dx + dy * dy;
+    }
+
+    static bool SegmentOverlaps(const Bounds& b, const sf::Vector2f& from, const sf::Vector2f& direction, float maxFraction);
+
+    std::int32_t AllocateNode();
+    void FreeNode(std::int32_t node);
+    void InsertLeaf(std::int32_t leaf);
+    void RemoveLeaf(std::int32_t leaf);
+    std::int32_t Balance(std::int32_t index);
+
+    std::vector<Node> _nodes;
+    std::int32_t _root = NULL_NODE;
+    std::int32_t _freeList = NULL_NODE;
+    std::size_t _proxyCount = 0;
+};
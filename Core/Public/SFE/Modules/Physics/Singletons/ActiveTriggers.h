@@ -0,0 +1,14 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include <flecs.h>
+#include <vector>
+
+/**
+ * @brief Triggers with TriggerEvents during the last physics step, so game code doesn't have to scan all of them.
+ */
+struct ActiveTriggers
+{
+    std::vector<flecs::entity> triggers;
+};
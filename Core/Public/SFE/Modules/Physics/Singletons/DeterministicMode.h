@@ -0,0 +1,19 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Bit-identical simulation across runs of the same binary, for replays and regression runs.
+ *
+ * When enabled, the Random generator is seeded with the seed, the GameInstance advances the world by the fixed delta
+ * time instead of the measured frame time, the physics processes its bodies and pairs in entity order, and a
+ * StateChecksum is computed at the end of every frame.
+ */
+struct DeterministicMode
+{
+    bool enabled = false;
+    std::uint32_t seed = 0;
+    float fixedDeltaTime = 1.f / 60.f;
+};
@@ -0,0 +1,30 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include <chrono>
+
+/**
+ * @brief Counters of the last physics step, meant for telemetry and debug overlays.
+ */
+struct PhysicsStats
+{
+    // Substeps the last frame was split into, the other counters are about the last substep
+    int substeps = 1;
+    int awakeBodies = 0;
+    int sleepingBodies = 0;
+    // Broadphase pairs with overlapping bounds, before and after the CollisionFilter
+    int pairsBeforeFilter = 0;
+    int pairsAfterFilter = 0;
+    int contacts = 0;
+    int staticColliders = 0;
+    // Contacts between an awake body and a static collider
+    int staticContacts = 0;
+    // Continuous bodies rewound to their time of impact
+    int timeOfImpactHits = 0;
+    // Bodies currently overlapping a trigger
+    int triggerPairs = 0;
+    // Gathering the bodies up to the pairs, then the time of impact and contacts against bodies and statics
+    std::chrono::nanoseconds broadphaseTime{0};
+    std::chrono::nanoseconds narrowphaseTime{0};
+};
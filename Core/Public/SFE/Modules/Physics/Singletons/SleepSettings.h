@@ -0,0 +1,12 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+struct SleepSettings
+{
+    // Below this speed (in px/s) a body is considered at rest
+    float linearThreshold = 5.f;
+    // How long a whole island must stay at rest before it is put to sleep
+    float timeToSleep = 0.5f;
+    bool enabled = true;
+};
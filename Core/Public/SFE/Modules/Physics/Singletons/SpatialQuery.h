@@ -0,0 +1,103 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include "SFE/Modules/Physics/Components/CollisionFilter.h"
+#include "SFE/Modules/Physics/DynamicAABBTree.h"
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <flecs.h>
+
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+struct RaycastHit
+{
+    flecs::entity entity;
+    sf::Vector2f point;
+    sf::Vector2f normal;
+    float distance = 0.f;
+};
+
+struct NearestHit
+{
+    flecs::entity entity;
+    float distance = 0.f;
+};
+
+/**
+ * @brief Answers "what is there" questions about the world without iterating every entity.
+ *
+ * Colliders and entities with a CollisionFilter are indexed in a DynamicAABBTree when they have a Transform and a
+ * Radius (circle centered on the position) or a Size (box starting at the position). The PhysicsModule keeps the index
+ * in sync: setting the shape reindexes the entity, and every indexed entity is refit in OnValidate, however its
+ * Transform was moved. Only the proxies leaving their fat AABB touch the tree.
+ *
+ * The queries write into the span given by the caller and return how many results were written, they never allocate.
+ * The mask is tested against the CollisionFilter layer of the entities.
+ */
+class SpatialQuery
+{
+public:
+    explicit SpatialQuery(const flecs::world_t* world = nullptr);
+
+    /**
+     * @brief Closest hits along the ray first, at most hits.size() of them.
+     */
+    std::size_t Raycast(const sf::Vector2f& origin, const sf::Vector2f& direction, float maxDistance,
+                        std::span<RaycastHit> hits, std::uint32_t mask = CollisionLayer::All) const;
+
+    std::size_t OverlapPoint(const sf::Vector2f& point, std::span<flecs::entity> results,
+                             std::uint32_t mask = CollisionLayer::All) const;
+
+    std::size_t OverlapBox(const sf::FloatRect& box, std::span<flecs::entity> results,
+                           std::uint32_t mask = CollisionLayer::All) const;
+
+    /**
+     * @brief The results.size() closest entities to the point, closest first. The distance is measured to the shape.
+     */
+    std::size_t Nearest(const sf::Vector2f& point, std::span<NearestHit> results,
+                        std::uint32_t mask = CollisionLayer::All) const;
+
+    // --- Index maintenance, driven by the PhysicsModule ---
+    void SetCircle(flecs::entity_t entity, const sf::Vector2f& center, float radius, std::uint32_t layer);
+    void SetBox(flecs::entity_t entity, const sf::FloatRect& box, std::uint32_t layer);
+    /**
+     * @brief Cheap refit of an indexed entity to its Transform position, the tree is only touched when it leaves its
+     * fat AABB.
+     */
+    void Move(flecs::entity_t entity, const sf::Vector2f& position);
+    void Remove(flecs::entity_t entity);
+
+    [[nodiscard]] std::size_t Size() const;
+    [[nodiscard]] const DynamicAABBTree& GetTree() const;
+
+private:
+    struct Shape
+    {
+        flecs::entity_t entity = 0;
+        std::uint32_t layer = CollisionLayer::Default;
+        // Center and radius of a circle, or the box when the radius is negative
+        sf::Vector2f center;
+        float radius = -1.f;
+        sf::FloatRect box;
+
+        [[nodiscard]] bool IsCircle() const
+        {
+            return radius >= 0.f;
+        }
+
+        [[nodiscard]] sf::FloatRect Bounds() const;
+    };
+
+    void Set(flecs::entity_t entity, const Shape& shape);
+
+    const flecs::world_t* _world = nullptr;
+    DynamicAABBTree _tree;
+    // Indexed by tree node, a proxy keeps its node for its whole life
+    std::vector<Shape> _shapes;
+    std::unordered_map<flecs::entity_t, std::int32_t> _proxies;
+};
@@ -0,0 +1,16 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Hash of every Transform and Velocity of the frame, only computed in DeterministicMode.
+ *
+ * The hash doesn't depend on the iteration order, two runs diverged as soon as their checksums differ for the same frame.
+ */
+struct StateChecksum
+{
+    std::uint64_t hash = 0;
+    int entities = 0;
+};
@@ -0,0 +1,15 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+/**
+ * @brief How the physics splits a frame into substeps.
+ *
+ * The fastest awake body decides: the frame is split so it never moves more than maxDisplacementRatio times its
+ * radius in one substep. Calm frames run a single step, and maxSubsteps caps what a violent frame can cost.
+ */
+struct SubstepSettings
+{
+    float maxDisplacementRatio = 0.5f;
+    int maxSubsteps = 4;
+};
@@ -5,6 +5,11 @@
 
 
 
+/**
+ * @brief UI element reacting to the left mouse button, within its Transform and Size.
+ *
+ * The UIModule puts it on the UI layer of the SpatialQuery, the PhysicsModule refits it when its Transform moves.
+ */
 struct Clickable
 {
     bool isClicked = false;
@@ -8,6 +8,8 @@
  * @struct WindowResizeIntent
  *
  * @brief Represents an intent to resize the window with details about the new and old dimensions.
+ *
+ * Only emitted on the event bus, subscribe to it with Events::Subscribe<WindowResizeIntent>.
  */
 struct WindowResizeIntent
 {
@@ -0,0 +1,12 @@
+// Copyright (c) Eric Jeker 2025.
+
+#pragma once
+
+
+/**
+ * @brief Added to the world by GameInstance::RunHeadless, the systems drawing to or reading from the window skip while
+ * it is there.
+ */
+struct Headless
+{
+};